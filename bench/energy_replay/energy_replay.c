@@ -0,0 +1,351 @@
+#define DT_DRV_COMPAT zmk_energy_replay_leds
+
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/led.h>
+#include <zephyr/kernel.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <cmdline.h>
+#include <nsi_host_trampolines.h>
+#include <posix_board_if.h>
+#include <soc.h>
+
+#include <drivers/emul_npm1300.h>
+
+#include <zmk/activity.h>
+#include <zmk/endpoints.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#include <zmk/hid.h>
+#include <zmk/hid_indicators.h>
+#include <zmk/usb.h>
+
+// Replays a recorded event trace through the drivers on native_sim and
+// estimates the average battery current from a simple per-operation model.
+//
+// Run with "zephyr.exe -trace=<file>". Each line of the trace is
+//
+//   <time ms> key <position> <press|release>
+//   <time ms> usb <0|1>
+//   <time ms> indicators <HID indicator bitmask>
+//   <time ms> end
+//
+// Lines starting with '#' are comments. Idle periods are gaps between events,
+// during which ZMK's own idle and sleep timeouts apply as usual.
+//
+// The model, with all charge in nC (uA * ms):
+// - A constant base current for the whole trace.
+// - A fixed charge per CPU wakeup, counted with the user tracing idle hook.
+// - A fixed charge per I2C byte to the PMIC, counted by the nPM1300 emulator.
+// - LED current scaled by brightness. The energy-replay snippet points the
+//   indicators at a zmk,energy-replay-leds controller, which records the
+//   brightness of each LED over time.
+// - PWM peripheral current while any LED is dimmed (lit at less than 100%),
+//   since that is when an LED needs PWM rather than a GPIO.
+//
+// "usb" events change both the PMIC's VBUS and the USB connection state that
+// zmk_usb_is_powered() reports, since both see VBUS on the keyboard. This does
+// not fully match the keyboard, though: ZMK's activity.c only checks USB power
+// before sleeping if the USB device stack is enabled, and the replay needs it
+// disabled. A replay can therefore go to sleep on USB power when the keyboard
+// wouldn't. The example traces end before the sleep timeout, and the report
+// warns if it happens.
+
+#define MAX_LINE_LENGTH 64
+#define MAX_LEDS 8
+// The base and offset bytes sent with every register access.
+#define I2C_ADDRESS_BYTES 2
+
+static const struct emul *pmic = EMUL_DT_GET(DT_NODELABEL(npm1300_pmic));
+
+static char *trace_path = NULL;
+static char trace[CONFIG_ZMK_ENERGY_REPLAY_MAX_TRACE_SIZE];
+static size_t trace_length;
+
+static atomic_t wakeups;
+
+static enum zmk_usb_conn_state usb_conn_state = ZMK_USB_CONN_NONE;
+// Number of times the keyboard went to sleep while on USB power.
+static uint32_t usb_sleeps;
+
+struct led_usage {
+    uint8_t brightness;
+    int64_t changed_at;
+    // Sum of brightness (percent) * time (ms)
+    uint64_t percent_ms;
+};
+
+static struct led_usage leds[MAX_LEDS];
+static int64_t dimmed_since = -1;
+static uint64_t pwm_active_ms;
+
+static void add_cmdline_opts(void) {
+    static struct args_struct_t opts[] = {
+        {
+            .option = "trace",
+            .name = "path",
+            .type = 's',
+            .dest = (void *)&trace_path,
+            .descript = "Event trace to replay for the energy estimate",
+        },
+        ARG_TABLE_ENDMARKER,
+    };
+
+    native_add_command_line_opts(opts);
+}
+
+NATIVE_TASK(add_cmdline_opts, PRE_BOOT_1, 1);
+
+void sys_trace_idle_user(void) { atomic_inc(&wakeups); }
+
+static bool any_led_dimmed(void) {
+    for (int i = 0; i < ARRAY_SIZE(leds); i++) {
+        if (leds[i].brightness > 0 && leds[i].brightness < LED_BRIGHTNESS_MAX) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void update_led(struct led_usage *led, uint8_t brightness, int64_t now) {
+    led->percent_ms += (uint64_t)led->brightness * (now - led->changed_at);
+    led->brightness = brightness;
+    led->changed_at = now;
+
+    const bool dimmed = any_led_dimmed();
+    if (dimmed && dimmed_since < 0) {
+        dimmed_since = now;
+    } else if (!dimmed && dimmed_since >= 0) {
+        pwm_active_ms += now - dimmed_since;
+        dimmed_since = -1;
+    }
+}
+
+// Starts counting LED usage from now.
+static void reset_led_usage(int64_t now) {
+    for (int i = 0; i < ARRAY_SIZE(leds); i++) {
+        leds[i].changed_at = now;
+        leds[i].percent_ms = 0;
+    }
+
+    dimmed_since = any_led_dimmed() ? now : -1;
+    pwm_active_ms = 0;
+}
+
+static int replay_led_set_brightness(const struct device *dev, uint32_t led, uint8_t value) {
+    if (led >= ARRAY_SIZE(leds)) {
+        return -EINVAL;
+    }
+
+    update_led(&leds[led], value, k_uptime_get());
+    return 0;
+}
+
+static DEVICE_API(led, replay_led_api) = {
+    .set_brightness = replay_led_set_brightness,
+};
+
+#define REPLAY_LEDS_DEFINE(n)                                                                      \
+    BUILD_ASSERT(DT_INST_CHILD_NUM(n) <= MAX_LEDS, "Too many LEDs. Increase MAX_LEDS.");           \
+                                                                                                   \
+    DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL, CONFIG_LED_INIT_PRIORITY,        \
+                          &replay_led_api);
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 1,
+             "Only one zmk,energy-replay-leds node is supported");
+
+DT_INST_FOREACH_STATUS_OKAY(REPLAY_LEDS_DEFINE)
+
+// native_sim has no USB device stack, so ZMK's usb.c isn't built. This takes
+// its place, reporting the state set by the trace.
+enum zmk_usb_conn_state zmk_usb_get_conn_state(void) { return usb_conn_state; }
+
+static void set_usb_powered(bool powered) {
+    emul_npm1300_set_vbus(pmic, powered);
+
+    // No host enumerates the simulated keyboard, so it is only ever powered.
+    usb_conn_state = powered ? ZMK_USB_CONN_POWERED : ZMK_USB_CONN_NONE;
+    raise_zmk_usb_conn_state_changed(
+        (struct zmk_usb_conn_state_changed){.conn_state = usb_conn_state});
+}
+
+static int energy_replay_activity_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+
+    if (ev->state == ZMK_ACTIVITY_SLEEP && usb_conn_state != ZMK_USB_CONN_NONE) {
+        usb_sleeps++;
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(energy_replay, energy_replay_activity_listener);
+ZMK_SUBSCRIPTION(energy_replay, zmk_activity_state_changed);
+
+static int load_trace(void) {
+    if (!trace_path) {
+        printk("Usage: zephyr.exe -trace=<file>\n");
+        return -EINVAL;
+    }
+
+    // O_RDONLY is 0 on every host native_sim runs on.
+    const int fd = nsi_host_open(trace_path, 0);
+    if (fd < 0) {
+        printk("Failed to open %s\n", trace_path);
+        return -ENOENT;
+    }
+
+    const long length = nsi_host_read(fd, trace, sizeof(trace) - 1);
+    nsi_host_close(fd);
+
+    if (length < 0) {
+        printk("Failed to read %s\n", trace_path);
+        return -EIO;
+    }
+
+    if (length == sizeof(trace) - 1) {
+        printk("%s is too large. Increase CONFIG_ZMK_ENERGY_REPLAY_MAX_TRACE_SIZE.\n", trace_path);
+        return -EFBIG;
+    }
+
+    trace_length = length;
+    trace[trace_length] = '\0';
+    return 0;
+}
+
+static void raise_key(uint32_t position, bool pressed) {
+    raise_zmk_position_state_changed((struct zmk_position_state_changed){
+        .source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL,
+        .position = position,
+        .state = pressed,
+        .timestamp = k_uptime_get(),
+    });
+}
+
+static void set_indicators(uint8_t indicators) {
+    struct zmk_hid_led_report_body report = {.leds = indicators};
+    zmk_hid_indicators_process_report(&report, zmk_endpoints_selected());
+}
+
+// Returns false when the trace ends.
+static bool replay_line(char *line, int line_number) {
+    char *saveptr;
+    const char *time = strtok_r(line, " \t\r", &saveptr);
+    const char *event = strtok_r(NULL, " \t\r", &saveptr);
+    const char *arg1 = strtok_r(NULL, " \t\r", &saveptr);
+    const char *arg2 = strtok_r(NULL, " \t\r", &saveptr);
+
+    if (!time || time[0] == '#') {
+        return true;
+    }
+
+    if (!event) {
+        printk("Line %d: missing event\n", line_number);
+        return true;
+    }
+
+    const int64_t delay = strtoll(time, NULL, 10) - k_uptime_get();
+    if (delay > 0) {
+        k_sleep(K_MSEC(delay));
+    }
+
+    if (strcmp(event, "end") == 0) {
+        return false;
+    }
+
+    if (strcmp(event, "key") == 0 && arg1 && arg2) {
+        raise_key(strtoul(arg1, NULL, 10), strcmp(arg2, "press") == 0);
+    } else if (strcmp(event, "usb") == 0 && arg1) {
+        set_usb_powered(strtoul(arg1, NULL, 10) != 0);
+    } else if (strcmp(event, "indicators") == 0 && arg1) {
+        set_indicators(strtoul(arg1, NULL, 0));
+    } else {
+        printk("Line %d: invalid event \"%s\"\n", line_number, event);
+    }
+
+    return true;
+}
+
+static void report(int64_t start, int64_t end) {
+    const int64_t duration_ms = MAX(end - start, 1);
+
+    for (int i = 0; i < ARRAY_SIZE(leds); i++) {
+        update_led(&leds[i], leds[i].brightness, end);
+    }
+    if (dimmed_since >= 0) {
+        pwm_active_ms += end - dimmed_since;
+    }
+
+    uint64_t led_percent_ms = 0;
+    for (int i = 0; i < ARRAY_SIZE(leds); i++) {
+        led_percent_ms += leds[i].percent_ms;
+    }
+
+    struct emul_npm1300_stats stats;
+    emul_npm1300_get_stats(pmic, &stats);
+
+    const uint32_t i2c_bytes =
+        stats.bytes_read + stats.bytes_written + stats.transactions * I2C_ADDRESS_BYTES;
+    const uint32_t cpu_wakeups = atomic_get(&wakeups);
+
+    const uint64_t base_nc = (uint64_t)CONFIG_ZMK_ENERGY_REPLAY_BASE_UA * duration_ms;
+    const uint64_t wakeup_nc = (uint64_t)CONFIG_ZMK_ENERGY_REPLAY_WAKEUP_NC * cpu_wakeups;
+    const uint64_t i2c_nc = (uint64_t)CONFIG_ZMK_ENERGY_REPLAY_I2C_BYTE_NC * i2c_bytes;
+    const uint64_t led_nc = (uint64_t)CONFIG_ZMK_ENERGY_REPLAY_LED_UA * led_percent_ms / 100;
+    const uint64_t pwm_nc = (uint64_t)CONFIG_ZMK_ENERGY_REPLAY_PWM_UA * pwm_active_ms;
+    const uint64_t total_nc = base_nc + wakeup_nc + i2c_nc + led_nc + pwm_nc;
+
+    printk("Scenario:     %s\n", trace_path);
+    printk("Duration:     %lld ms\n", duration_ms);
+    printk("CPU wakeups:  %u (%llu uA)\n", cpu_wakeups, wakeup_nc / duration_ms);
+    printk("I2C:          %u transfers, %u bytes (%llu uA)\n", stats.transactions, i2c_bytes,
+           i2c_nc / duration_ms);
+    printk("LEDs:         %llu %%*ms (%llu uA)\n", led_percent_ms, led_nc / duration_ms);
+    printk("PWM active:   %llu ms (%llu uA)\n", pwm_active_ms, pwm_nc / duration_ms);
+    printk("Base:         %llu uA\n", base_nc / duration_ms);
+    printk("Average:      %llu uA\n", total_nc / duration_ms);
+
+    if (usb_sleeps > 0) {
+        printk("Warning: slept %u times on USB power, which the keyboard doesn't do.\n",
+               usb_sleeps);
+    }
+}
+
+static void energy_replay_thread(void *p1, void *p2, void *p3) {
+    if (load_trace() != 0) {
+        posix_exit(1);
+    }
+
+    const int64_t start = k_uptime_get();
+    emul_npm1300_reset_stats(pmic);
+    atomic_set(&wakeups, 0);
+    reset_led_usage(start);
+
+    int line_number = 0;
+    char *line = trace;
+    while (line) {
+        char *next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+
+        line_number++;
+        if (!replay_line(line, line_number)) {
+            break;
+        }
+
+        line = next;
+    }
+
+    report(start, k_uptime_get());
+    posix_exit(0);
+}
+
+K_THREAD_DEFINE(energy_replay, CONFIG_ZMK_ENERGY_REPLAY_STACK_SIZE, energy_replay_thread, NULL,
+                NULL, NULL, K_LOWEST_APPLICATION_THREAD_PRIO, 0, 0);
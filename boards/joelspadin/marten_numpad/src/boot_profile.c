@@ -0,0 +1,146 @@
+#include <zephyr/device.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/timing/timing.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Records how long each SYS_INIT function and device init takes using the user
+// tracing hooks, plus the time until the first key press, and logs it all once
+// the keyboard has finished booting.
+//
+// Recording only reads the cycle counter and stores it. Init entries that don't
+// fit in the table are only counted.
+
+// Init levels, in the order the kernel runs them.
+static const char *const level_names[] = {
+    "EARLY", "PRE_KERNEL_1", "PRE_KERNEL_2", "POST_KERNEL", "APPLICATION", "SMP",
+};
+
+struct boot_profile_entry {
+    const struct init_entry *entry;
+    uint32_t start;
+    uint32_t cycles;
+    uint8_t level;
+    int8_t result;
+};
+
+static struct boot_profile_entry entries[CONFIG_BOARD_BOOT_PROFILE_MAX_ENTRIES];
+static size_t num_entries;
+static size_t num_dropped;
+
+static bool timing_started = false;
+static timing_t boot_start;
+static timing_t entry_start;
+
+static uint32_t cycles_since(timing_t start) {
+    timing_t now = timing_counter_get();
+    return (uint32_t)timing_cycles_get(&start, &now);
+}
+
+void sys_trace_sys_init_enter_user(const struct init_entry *entry, int level) {
+    if (!timing_started) {
+        timing_init();
+        timing_start();
+        boot_start = timing_counter_get();
+        timing_started = true;
+    }
+
+    entry_start = timing_counter_get();
+}
+
+void sys_trace_sys_init_exit_user(const struct init_entry *entry, int level, int result) {
+    const uint32_t cycles = cycles_since(entry_start);
+
+    if (num_entries >= ARRAY_SIZE(entries)) {
+        num_dropped++;
+        return;
+    }
+
+    entries[num_entries++] = (struct boot_profile_entry){
+        .entry = entry,
+        .start = (uint32_t)timing_cycles_get(&boot_start, &entry_start),
+        .cycles = cycles,
+        .level = level,
+        .result = CLAMP(result, INT8_MIN, INT8_MAX),
+    };
+}
+
+static uint32_t cycles_to_us(uint32_t cycles) {
+    return (uint32_t)(timing_cycles_to_ns(cycles) / NSEC_PER_USEC);
+}
+
+static void log_entry(const struct boot_profile_entry *e) {
+    const uint32_t us = cycles_to_us(e->cycles);
+    if (us < CONFIG_BOARD_BOOT_PROFILE_MIN_US && e->result == 0) {
+        return;
+    }
+
+    // SYS_INIT functions have no name at runtime. Look up the address of the
+    // entry in zephyr.map to find it.
+    if (e->entry->dev) {
+        LOG_INF("  %-24s +%7u us %6u us (%d)", e->entry->dev->name, cycles_to_us(e->start), us,
+                e->result);
+    } else {
+        LOG_INF("  init@%p +%7u us %6u us (%d)", (void *)e->entry, cycles_to_us(e->start), us,
+                e->result);
+    }
+}
+
+static void report_work_handler(struct k_work *work) {
+    uint32_t level_cycles[ARRAY_SIZE(level_names)] = {0};
+
+    LOG_INF("Boot profile: %zu init entries, %zu not recorded", num_entries, num_dropped);
+
+    for (int i = 0; i < num_entries; i++) {
+        const struct boot_profile_entry *e = &entries[i];
+
+        if (i == 0 || e->level != entries[i - 1].level) {
+            LOG_INF("%s:", e->level < ARRAY_SIZE(level_names) ? level_names[e->level] : "?");
+        }
+
+        if (e->level < ARRAY_SIZE(level_cycles)) {
+            level_cycles[e->level] += e->cycles;
+        }
+
+        log_entry(e);
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(level_names); i++) {
+        if (level_cycles[i] > 0) {
+            LOG_INF("Total %s: %u us", level_names[i], cycles_to_us(level_cycles[i]));
+        }
+    }
+}
+
+static K_WORK_DELAYABLE_DEFINE(report_work, report_work_handler);
+
+static int boot_profile_listener(const zmk_event_t *eh) {
+    static bool first_key_seen = false;
+
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+    if (ev && ev->state && !first_key_seen) {
+        first_key_seen = true;
+        // Time since the kernel started. Time spent leaving ship mode and in
+        // the bootloader isn't included.
+        LOG_INF("First key press at %lld ms", k_uptime_get());
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(boot_profile, boot_profile_listener);
+ZMK_SUBSCRIPTION(boot_profile, zmk_position_state_changed);
+
+static int boot_profile_init(void) {
+    // Wait for a log backend to connect before dumping everything.
+    k_work_schedule(&report_work, K_MSEC(CONFIG_BOARD_BOOT_PROFILE_REPORT_DELAY_MS));
+    return 0;
+}
+
+// Run as late as possible so most APPLICATION entries are recorded.
+SYS_INIT(boot_profile_init, APPLICATION, 99);
@@ -0,0 +1,123 @@
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/charger.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+
+#include "peripheral_power.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// When the charger reports USB power, power usage doesn't matter, so this
+// switches to settings that minimize input latency and keeps the peripheral
+// connector powered. When USB is removed, it switches back to the normal
+// power-saving settings. Indicator LEDs already stay lit on USB power.
+//
+// TODO: also shorten the kscan matrix debounce and scan period. ZMK's
+// kscan-gpio-matrix only takes these from devicetree at build time, so that
+// needs a runtime setting in ZMK first.
+
+// Shortest connection interval allowed by the spec (7.5 ms) with no peripheral
+// latency, so every connection event can carry a report.
+#define USB_CONN_INTERVAL 6
+#define USB_CONN_LATENCY 0
+#define USB_CONN_TIMEOUT 400
+
+// ZMK requests its own connection parameters right after connecting, so wait
+// for that to finish before replacing them.
+#define CONN_PARAM_UPDATE_DELAY K_SECONDS(2)
+
+static const struct device *charger = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger_wrapper));
+
+static bool usb_performance_active = false;
+
+static const struct bt_le_conn_param usb_conn_param = BT_LE_CONN_PARAM_INIT(
+    USB_CONN_INTERVAL, USB_CONN_INTERVAL, USB_CONN_LATENCY, USB_CONN_TIMEOUT);
+
+static const struct bt_le_conn_param default_conn_param =
+    BT_LE_CONN_PARAM_INIT(CONFIG_BT_PERIPHERAL_PREF_MIN_INT, CONFIG_BT_PERIPHERAL_PREF_MAX_INT,
+                          CONFIG_BT_PERIPHERAL_PREF_LATENCY, CONFIG_BT_PERIPHERAL_PREF_TIMEOUT);
+
+static const struct bt_le_conn_param *get_conn_param(void) {
+    return usb_performance_active ? &usb_conn_param : &default_conn_param;
+}
+
+static void update_conn_param(struct bt_conn *conn, void *user_data) {
+    struct bt_conn_info info;
+    if (bt_conn_get_info(conn, &info) || info.state != BT_CONN_STATE_CONNECTED) {
+        return;
+    }
+
+    const int err = bt_conn_le_param_update(conn, get_conn_param());
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to update connection parameters: %d", err);
+    }
+}
+
+static void handle_conn_param_work(struct k_work *work) {
+    bt_conn_foreach(BT_CONN_TYPE_LE, update_conn_param, NULL);
+}
+
+K_WORK_DELAYABLE_DEFINE(conn_param_work, handle_conn_param_work);
+
+static void set_usb_performance(bool active) {
+    if (usb_performance_active == active) {
+        return;
+    }
+
+    LOG_INF("USB performance mode %s", active ? "on" : "off");
+
+    usb_performance_active = active;
+    k_work_reschedule(&conn_param_work, K_NO_WAIT);
+
+#if IS_ENABLED(CONFIG_BOARD_PERIPHERAL_POWER)
+    peripheral_power_set_keep_on(active);
+#endif
+}
+
+static void handle_connected(struct bt_conn *conn, uint8_t err) {
+    if (err || !usb_performance_active) {
+        return;
+    }
+
+    k_work_reschedule(&conn_param_work, CONN_PARAM_UPDATE_DELAY);
+}
+
+BT_CONN_CB_DEFINE(usb_performance_conn_callbacks) = {
+    .connected = handle_connected,
+};
+
+static void handle_charger_online(enum charger_online online) {
+    set_usb_performance(online != CHARGER_ONLINE_OFFLINE);
+}
+
+static int marten_numpad_performance_init(void) {
+    if (!device_is_ready(charger)) {
+        printk("Charger not ready\n");
+        return 0;
+    }
+
+    union charger_propval val = {.online_notification = handle_charger_online};
+    int err = charger_set_prop(charger, CHARGER_PROP_ONLINE_NOTIFICATION, &val);
+    if (err) {
+        printk("Failed to set charger online notifier: %d\n", err);
+        return 0;
+    }
+
+    // The charger may have read its initial state before the notifier was set.
+    // Reading the online state doesn't touch the bus.
+    err = charger_get_prop(charger, CHARGER_PROP_ONLINE, &val);
+    if (err) {
+        printk("Failed to read charger online: %d\n", err);
+        return 0;
+    }
+
+    handle_charger_online(val.online);
+
+    return 0;
+}
+
+SYS_INIT(marten_numpad_performance_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,124 @@
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/init.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <zmk/activity.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include "peripheral_power.h"
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY)
+#include <lvgl.h>
+#include <zmk/display.h>
+#endif
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Keeps the marten_peripheral power domain on while the device plugged into it
+// is needed, and turns it off otherwise.
+//
+// The bus drivers also take a reference on the domain for every transfer, but
+// if this didn't hold one in between, the domain would turn off after each
+// transfer and the display would lose what it was showing.
+
+// Keep the display powered while idle unless ZMK blanks it.
+#define POWER_OFF_ON_IDLE                                                                          \
+    (!IS_ENABLED(CONFIG_ZMK_DISPLAY) || IS_ENABLED(CONFIG_ZMK_DISPLAY_BLANK_ON_IDLE))
+
+static const struct device *domain = DEVICE_DT_GET(DT_NODELABEL(marten_power));
+
+static bool powered = false;
+static bool keep_on = false;
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY)
+
+static void redraw_work_handler(struct k_work *work) {
+    // Whatever was on the display was lost while it was unpowered.
+    lv_obj_invalidate(lv_screen_active());
+}
+
+static K_WORK_DEFINE(redraw_work, redraw_work_handler);
+
+#endif
+
+static void set_powered(bool on) {
+    if (on == powered) {
+        return;
+    }
+
+    if (on) {
+        const int ret = pm_device_runtime_get(domain);
+        if (ret < 0) {
+            LOG_ERR("Failed to power on peripheral: %d", ret);
+            return;
+        }
+
+#if IS_ENABLED(CONFIG_ZMK_DISPLAY)
+        k_work_submit_to_queue(zmk_display_work_q(), &redraw_work);
+#endif
+    } else {
+        const int ret = pm_device_runtime_put(domain);
+        if (ret < 0) {
+            LOG_ERR("Failed to power off peripheral: %d", ret);
+            return;
+        }
+    }
+
+    LOG_DBG("Peripheral power %s", on ? "on" : "off");
+    powered = on;
+}
+
+static void update_powered(enum zmk_activity_state state) {
+    if (keep_on) {
+        set_powered(true);
+        return;
+    }
+
+    switch (state) {
+    case ZMK_ACTIVITY_ACTIVE:
+        set_powered(true);
+        break;
+
+    case ZMK_ACTIVITY_IDLE:
+        set_powered(!POWER_OFF_ON_IDLE);
+        break;
+
+    case ZMK_ACTIVITY_SLEEP:
+        set_powered(false);
+        break;
+    }
+}
+
+void peripheral_power_set_keep_on(bool on) {
+    keep_on = on;
+    update_powered(zmk_activity_get_state());
+}
+
+static int peripheral_power_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    if (!ev) {
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    update_powered(ev->state);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(peripheral_power, peripheral_power_listener);
+ZMK_SUBSCRIPTION(peripheral_power, zmk_activity_state_changed);
+
+static int peripheral_power_init(void) {
+    if (!device_is_ready(domain)) {
+        LOG_ERR("Peripheral power domain is not ready");
+        return -ENODEV;
+    }
+
+    set_powered(true);
+    return 0;
+}
+
+SYS_INIT(peripheral_power_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
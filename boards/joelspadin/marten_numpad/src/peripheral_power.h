@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * Keep the peripheral connector powered regardless of the activity state, e.g.
+ * while on USB power. Passing false restores the normal idle behavior.
+ */
+void peripheral_power_set_keep_on(bool on);
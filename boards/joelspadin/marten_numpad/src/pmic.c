@@ -9,6 +9,7 @@
 #include <zephyr/dt-bindings/regulator/npm1300.h>
 #include <zephyr/init.h>
 #include <zephyr/kernel.h>
+#include <zephyr/pm/device_runtime.h>
 #include <zephyr/sys/printk.h>
 
 #include <zmk/endpoints.h>
@@ -18,6 +19,8 @@
 #define ERRLOG_BASE 0x0EU
 #define ERRLOG_OFFSET_TASKCLRERRLOG 0x00U
 #define ERRLOG_OFFSET_RSTCAUSE 0x03U
+#define ERRLOG_OFFSET_CHARGERERRREASON 0x04U
+#define ERRLOG_OFFSET_CHARGERERRSENSOR 0x05U
 
 #define VBUS_BASE 0x02U
 #define VBUS_OFFSET_STATUS 0x07U
@@ -31,6 +34,40 @@ static const struct device *pmic = DEVICE_DT_GET(DT_NODELABEL(npm1300_pmic));
 
 static const struct led_dt_spec status_led = LED_DT_SPEC_GET(DT_NODELABEL(status_led));
 
+// The PWM controller is suspended while no LEDs are using it, so hold a
+// reference on it while using the status LED.
+static const struct device *status_led_pwm = DEVICE_DT_GET(DT_PWMS_CTLR(DT_NODELABEL(status_led)));
+
+// Only accessed from the system work queue.
+static bool status_led_held = false;
+
+static void hold_status_led(void) {
+    if (status_led_held) {
+        return;
+    }
+
+    const int err = pm_device_runtime_get(status_led_pwm);
+    if (err < 0) {
+        printk("Failed to resume status LED PWM: %d\n", err);
+        return;
+    }
+
+    status_led_held = true;
+}
+
+static void release_status_led(void) {
+    if (!status_led_held) {
+        return;
+    }
+
+    const int err = pm_device_runtime_put(status_led_pwm);
+    if (err < 0) {
+        printk("Failed to suspend status LED PWM: %d\n", err);
+    }
+
+    status_led_held = false;
+}
+
 #if IS_ENABLED(CONFIG_BOARD_POWER_BUTTON_SOFT_OFF)
 
 static bool vbus_present = false;
@@ -57,10 +94,14 @@ static void handle_vbus_event(const struct device *dev, struct gpio_callback *cb
 }
 
 static void fade_status_led(void) {
+    hold_status_led();
+
     for (int brightness = 50; brightness >= 0; brightness--) {
         led_set_brightness_dt(&status_led, brightness);
         k_sleep(K_MSEC(10));
     }
+
+    release_status_led();
 }
 
 static void enter_ship_mode(struct k_work *work) {
@@ -100,6 +141,13 @@ static void handle_blink_work(struct k_work *work) {
     static bool led_state = false;
     static int led_blink_count = 2;
 
+    // The timer may have queued this again just before it was stopped, or the
+    // ship mode fade may have taken over the LED.
+    if (!status_led_held) {
+        k_timer_stop(&blink_timer);
+        return;
+    }
+
     if (led_state) {
         led_off_dt(&status_led);
         led_state = false;
@@ -111,19 +159,31 @@ static void handle_blink_work(struct k_work *work) {
 
     if (led_blink_count <= 0) {
         k_timer_stop(&blink_timer);
+        release_status_led();
     }
 }
 
 static void handle_blink_timer(struct k_timer *timer) { k_work_submit(&blink_work); }
 
 static uint8_t get_reset_cause(void) {
-    uint8_t reset_cause;
-    int err = mfd_npm1300_reg_read(pmic, ERRLOG_BASE, ERRLOG_OFFSET_RSTCAUSE, &reset_cause);
+    // RSTCAUSE, CHARGERERRREASON, and CHARGERERRSENSOR are adjacent, so read
+    // them in one transfer before clearing the log.
+    uint8_t errlog[ERRLOG_OFFSET_CHARGERERRSENSOR - ERRLOG_OFFSET_RSTCAUSE + 1];
+    int err = mfd_npm1300_reg_read_burst(pmic, ERRLOG_BASE, ERRLOG_OFFSET_RSTCAUSE, errlog,
+                                         sizeof(errlog));
     if (err) {
         printk("Failed to get reset cause: %d\n", err);
         return 0;
     }
 
+    const uint8_t reset_cause = errlog[0];
+    const uint8_t charger_reason = errlog[ERRLOG_OFFSET_CHARGERERRREASON - ERRLOG_OFFSET_RSTCAUSE];
+    const uint8_t charger_sensor = errlog[ERRLOG_OFFSET_CHARGERERRSENSOR - ERRLOG_OFFSET_RSTCAUSE];
+
+    if (charger_reason != 0) {
+        printk("Charger error: reason %02x, sensor %02x\n", charger_reason, charger_sensor);
+    }
+
     err = mfd_npm1300_reg_write(pmic, ERRLOG_BASE, ERRLOG_OFFSET_TASKCLRERRLOG, 1U);
     if (err) {
         printk("Failed to clear error log: %d\n", err);
@@ -132,6 +192,18 @@ static uint8_t get_reset_cause(void) {
     return reset_cause;
 }
 
+static void handle_reset_cause_work(struct k_work *work) {
+    // If we reset due to some PMIC event, flash the status LED to indicate that
+    // we are powered back on. If we reset due to the nRF52's reset button, the
+    // bootloader will flash the LED on its own, so we don't need to do it again.
+    if (get_reset_cause() != 0) {
+        hold_status_led();
+        k_timer_start(&blink_timer, K_NO_WAIT, K_MSEC(150));
+    }
+}
+
+K_WORK_DEFINE(reset_cause_work, handle_reset_cause_work);
+
 static int marten_numpad_pmic_init(void) {
     if (!led_is_ready_dt(&status_led)) {
         printk("LED not ready\n");
@@ -162,12 +234,9 @@ static int marten_numpad_pmic_init(void) {
     vbus_present_init();
 #endif
 
-    // If we reset due to some PMIC event, flash the status LED to indicate that
-    // we are powered back on. If we reset due to the nRF52's reset button, the
-    // bootloader will flash the LED on its own, so we don't need to do it again.
-    if (get_reset_cause() != 0) {
-        k_timer_start(&blink_timer, K_NO_WAIT, K_MSEC(150));
-    }
+    // Nothing else depends on the reset cause, so don't hold up the rest of
+    // boot with I2C transfers for it.
+    k_work_submit(&reset_cause_work);
 
     return 0;
 }
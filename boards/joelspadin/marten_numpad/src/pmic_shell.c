@@ -0,0 +1,251 @@
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/fuel_gauge.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/drivers/sensor/npm1300_charger.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/crc.h>
+#include <stdlib.h>
+
+#include <drivers/npm1300_telemetry.h>
+
+// Adds a "pmic" shell command which prints the battery and charger state, or
+// streams it as fixed-size binary records for long captures.
+//
+// Stream record layout (16 bytes, little endian):
+//
+//   0  u8[2] sync (0xA5 0x5A)
+//   2  u32   uptime in ms
+//   6  u16   battery voltage in mV
+//   8  i32   average battery current in uA
+//   12 u8    state of charge in percent
+//   13 u8    charger status register
+//   14 u8    flags (bit 0: VBUS present, bit 1: charging suspended by die temp)
+//   15 u8    CRC-8/CCITT of bytes 0-14
+//
+// Use scripts/pmic_stream_to_csv.py to convert a capture to CSV.
+
+#define STATUS_COMPLETED 0x02
+#define STATUS_TRICKLECHARGE 0x04
+#define STATUS_CONSTANTCURRENT 0x08
+#define STATUS_CONSTANTVOLTAGE 0x10
+#define STATUS_DIE_TEMP_HIGH 0x40
+
+#define VBUS_PRESENT 0x01
+
+#define FLAG_VBUS_PRESENT BIT(0)
+#define FLAG_DIE_TEMP_HIGH BIT(1)
+
+#define RECORD_SYNC_0 0xA5
+#define RECORD_SYNC_1 0x5A
+#define RECORD_SIZE 16
+
+#define STREAM_MIN_INTERVAL_MS 10
+#define STREAM_WRITE_RETRIES 10
+
+static const struct device *charger = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger));
+static const struct device *fuel_gauge = DEVICE_DT_GET(DT_CHOSEN(zmk_battery));
+
+struct pmic_sample {
+    uint16_t voltage_mv;
+    int32_t current_ua;
+    uint8_t soc;
+    uint8_t status;
+    uint8_t flags;
+};
+
+static int read_sample(struct pmic_sample *sample) {
+    struct sensor_value val;
+    int ret;
+
+    // Make sure every sample comes from a new fetch, regardless of the cache age.
+    npm1300_telemetry_invalidate(charger);
+
+    ret = npm1300_telemetry_get(charger, SENSOR_CHAN_GAUGE_VOLTAGE, &val);
+    if (ret) {
+        return ret;
+    }
+    sample->voltage_mv = val.val1 * 1000 + val.val2 / 1000;
+
+    ret = npm1300_telemetry_get(charger, SENSOR_CHAN_GAUGE_AVG_CURRENT, &val);
+    if (ret) {
+        return ret;
+    }
+    sample->current_ua = val.val1 * 1000000 + val.val2;
+
+    ret = npm1300_telemetry_get(charger, SENSOR_CHAN_NPM1300_CHARGER_STATUS, &val);
+    if (ret) {
+        return ret;
+    }
+    sample->status = val.val1;
+    sample->flags = (val.val1 & STATUS_DIE_TEMP_HIGH) ? FLAG_DIE_TEMP_HIGH : 0;
+
+    ret = npm1300_telemetry_get(charger, SENSOR_CHAN_NPM1300_CHARGER_VBUS_STATUS, &val);
+    if (ret) {
+        return ret;
+    }
+    if (val.val1 & VBUS_PRESENT) {
+        sample->flags |= FLAG_VBUS_PRESENT;
+    }
+
+    union fuel_gauge_prop_val soc;
+    ret = fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_ABSOLUTE_STATE_OF_CHARGE, &soc);
+    if (ret) {
+        return ret;
+    }
+    sample->soc = soc.absolute_state_of_charge;
+
+    return 0;
+}
+
+static const char *status_name(uint8_t status) {
+    if (status & STATUS_COMPLETED) {
+        return "full";
+    }
+    if (status & STATUS_TRICKLECHARGE) {
+        return "trickle charging";
+    }
+    if (status & STATUS_CONSTANTCURRENT) {
+        return "charging (constant current)";
+    }
+    if (status & STATUS_CONSTANTVOLTAGE) {
+        return "charging (constant voltage)";
+    }
+
+    return "not charging";
+}
+
+static int cmd_pmic_status(const struct shell *sh, size_t argc, char **argv) {
+    struct pmic_sample sample;
+
+    const int ret = read_sample(&sample);
+    if (ret) {
+        shell_error(sh, "Failed to read PMIC: %d", ret);
+        return ret;
+    }
+
+    shell_print(sh, "Voltage:  %u mV", sample.voltage_mv);
+    shell_print(sh, "Current:  %d uA", sample.current_ua);
+    shell_print(sh, "Charge:   %u%%", sample.soc);
+    shell_print(sh, "Status:   %s (0x%02x)", status_name(sample.status), sample.status);
+    shell_print(sh, "VBUS:     %s", (sample.flags & FLAG_VBUS_PRESENT) ? "present" : "absent");
+    shell_print(sh, "Die temp: %s",
+                (sample.flags & FLAG_DIE_TEMP_HIGH) ? "too high, charging suspended" : "ok");
+
+    return 0;
+}
+
+static void stream_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(stream_work, stream_work_handler);
+
+static const struct shell *stream_shell;
+static atomic_t streaming;
+static uint32_t stream_interval_ms;
+static uint32_t stream_records;
+static uint32_t stream_errors;
+
+static void encode_record(uint8_t record[RECORD_SIZE], const struct pmic_sample *sample) {
+    record[0] = RECORD_SYNC_0;
+    record[1] = RECORD_SYNC_1;
+    sys_put_le32(k_uptime_get_32(), &record[2]);
+    sys_put_le16(sample->voltage_mv, &record[6]);
+    sys_put_le32(sample->current_ua, &record[8]);
+    record[12] = sample->soc;
+    record[13] = sample->status;
+    record[14] = sample->flags;
+    record[15] = crc8_ccitt(0, record, RECORD_SIZE - 1);
+}
+
+static int write_raw(const struct shell *sh, const uint8_t *buf, size_t len) {
+    // The shell doesn't write anything while bypass is enabled, so the transport
+    // can be used directly without mixing the records with shell output.
+    for (int i = 0; i < STREAM_WRITE_RETRIES && len > 0; i++) {
+        size_t written = 0;
+        const int ret = sh->iface->api->write(sh->iface, buf, len, &written);
+        if (ret) {
+            return ret;
+        }
+
+        buf += written;
+        len -= written;
+
+        if (len > 0) {
+            k_sleep(K_MSEC(1));
+        }
+    }
+
+    return len > 0 ? -EAGAIN : 0;
+}
+
+static void stream_work_handler(struct k_work *work) {
+    struct pmic_sample sample;
+    uint8_t record[RECORD_SIZE];
+
+    if (!atomic_get(&streaming)) {
+        return;
+    }
+
+    k_work_schedule(&stream_work, K_MSEC(stream_interval_ms));
+
+    if (read_sample(&sample) != 0) {
+        stream_errors++;
+        return;
+    }
+
+    encode_record(record, &sample);
+
+    if (write_raw(stream_shell, record, sizeof(record)) != 0) {
+        stream_errors++;
+        return;
+    }
+
+    stream_records++;
+}
+
+static void stream_bypass_cb(const struct shell *sh, uint8_t *data, size_t len, void *user_data) {
+    struct k_work_sync sync;
+
+    // Any input stops the stream.
+    atomic_set(&streaming, false);
+    k_work_cancel_delayable_sync(&stream_work, &sync);
+    shell_set_bypass(sh, NULL, NULL);
+
+    shell_print(sh, "\nStream stopped: %u records, %u errors", stream_records, stream_errors);
+}
+
+static int cmd_pmic_stream(const struct shell *sh, size_t argc, char **argv) {
+    char *end;
+    const unsigned long interval = strtoul(argv[1], &end, 10);
+
+    if (*end != '\0' || interval < STREAM_MIN_INTERVAL_MS) {
+        shell_error(sh, "Interval must be a number of milliseconds >= %d",
+                    STREAM_MIN_INTERVAL_MS);
+        return -EINVAL;
+    }
+
+    stream_shell = sh;
+    stream_interval_ms = interval;
+    stream_records = 0;
+    stream_errors = 0;
+
+    shell_print(sh, "Streaming every %lu ms. Send any key to stop.", interval);
+
+    shell_set_bypass(sh, stream_bypass_cb, NULL);
+    atomic_set(&streaming, true);
+    k_work_schedule(&stream_work, K_NO_WAIT);
+
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_pmic,
+                               SHELL_CMD(status, NULL, "Print battery and charger state",
+                                         cmd_pmic_status),
+                               SHELL_CMD_ARG(stream, NULL,
+                                             "Stream binary state records\n"
+                                             "Usage: pmic stream <interval ms>",
+                                             cmd_pmic_stream, 2, 0),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(pmic, &sub_pmic, "nPM1300 PMIC status", NULL);
@@ -0,0 +1,14 @@
+#include <lvgl.h>
+
+#include "widgets/power_status.h"
+
+static struct zmk_widget_power_status power_status_widget;
+
+lv_obj_t *zmk_display_status_screen(void) {
+    lv_obj_t *screen = lv_obj_create(NULL);
+
+    zmk_widget_power_status_init(&power_status_widget, screen);
+    lv_obj_align(zmk_widget_power_status_obj(&power_status_widget), LV_ALIGN_TOP_LEFT, 0, 0);
+
+    return screen;
+}
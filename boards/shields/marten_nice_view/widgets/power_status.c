@@ -0,0 +1,209 @@
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/charger.h>
+#include <zephyr/drivers/fuel_gauge.h>
+#include <zephyr/kernel.h>
+#include <stdio.h>
+
+#include <zmk/display.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+
+#if IS_ENABLED(CONFIG_MARTEN_NICE_VIEW_LOG_MEMORY)
+#include <lvgl_mem.h>
+#endif
+
+#include "power_status.h"
+
+// Shows battery and charger state from the PMIC. The time to empty is only
+// shown while discharging, and only if the fuel gauge knows the battery's
+// capacity.
+//
+// Values are polled on the display work queue (and immediately after battery
+// or USB events), but each label is only updated when its value changes. LVGL
+// then only redraws and flushes the area covered by the labels that changed,
+// so an update that changes nothing doesn't touch the display at all.
+
+#define RUNTIME_UNKNOWN -1
+
+struct power_status_state {
+    uint8_t soc;
+    enum charger_status status;
+    bool online;
+    int32_t runtime_minutes;
+};
+
+static const struct device *fuel_gauge = DEVICE_DT_GET(DT_CHOSEN(zmk_battery));
+static const struct device *charger = DEVICE_DT_GET(DT_CHOSEN(zmk_charger));
+
+static struct zmk_widget_power_status *widget_instance;
+static struct power_status_state current_state;
+static bool drawn = false;
+
+// Label text is stored here instead of in the LVGL heap.
+static char soc_text[8];
+static char runtime_text[16];
+
+static void read_state(struct power_status_state *state) {
+    union fuel_gauge_prop_val fuel_val;
+    union charger_propval charger_val;
+
+    if (fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_ABSOLUTE_STATE_OF_CHARGE, &fuel_val) == 0) {
+        state->soc = fuel_val.absolute_state_of_charge;
+    }
+
+    if (fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_RUNTIME_TO_EMPTY, &fuel_val) == 0) {
+        state->runtime_minutes = fuel_val.runtime_to_empty;
+    } else {
+        state->runtime_minutes = RUNTIME_UNKNOWN;
+    }
+
+    if (charger_get_prop(charger, CHARGER_PROP_STATUS, &charger_val) == 0) {
+        state->status = charger_val.status;
+    }
+
+    if (charger_get_prop(charger, CHARGER_PROP_ONLINE, &charger_val) == 0) {
+        state->online = charger_val.online != CHARGER_ONLINE_OFFLINE;
+    }
+}
+
+static const char *get_state_text(const struct power_status_state *state) {
+    if (!state->online) {
+        return "Battery";
+    }
+
+    switch (state->status) {
+    case CHARGER_STATUS_CHARGING:
+        return "Charging";
+
+    case CHARGER_STATUS_FULL:
+        return "Full";
+
+    default:
+        return "Not charging";
+    }
+}
+
+static void update_labels(struct zmk_widget_power_status *widget,
+                          const struct power_status_state *state) {
+    if (!drawn || state->soc != current_state.soc) {
+        snprintf(soc_text, sizeof(soc_text), "%u%%", state->soc);
+        lv_label_set_text_static(widget->soc_label, soc_text);
+    }
+
+    if (!drawn || state->status != current_state.status || state->online != current_state.online) {
+        lv_label_set_text_static(widget->state_label, get_state_text(state));
+    }
+
+    if (!drawn || state->online != current_state.online) {
+        lv_label_set_text_static(widget->vbus_label, state->online ? LV_SYMBOL_USB : "");
+    }
+
+    if (!drawn || state->runtime_minutes != current_state.runtime_minutes) {
+        if (state->runtime_minutes == RUNTIME_UNKNOWN) {
+            runtime_text[0] = '\0';
+        } else {
+            snprintf(runtime_text, sizeof(runtime_text), "%dh %02dm", state->runtime_minutes / 60,
+                     state->runtime_minutes % 60);
+        }
+        lv_label_set_text_static(widget->runtime_label, runtime_text);
+    }
+
+    current_state = *state;
+    drawn = true;
+}
+
+#if IS_ENABLED(CONFIG_MARTEN_NICE_VIEW_LOG_MEMORY)
+static void log_stack_usage(void) {
+    struct k_thread *thread = k_work_queue_thread_get(zmk_display_work_q());
+    size_t unused;
+
+    if (k_thread_stack_space_get(thread, &unused) == 0) {
+        printk("Display thread stack: %zu of %zu bytes used\n",
+               thread->stack_info.size - unused, thread->stack_info.size);
+    }
+}
+#endif
+
+static void refresh_work_handler(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(refresh_work, refresh_work_handler);
+
+static void schedule_refresh(k_timeout_t delay) {
+    k_work_reschedule_for_queue(zmk_display_work_q(), &refresh_work, delay);
+}
+
+static void refresh_work_handler(struct k_work *work) {
+    struct power_status_state state = current_state;
+    read_state(&state);
+
+    if (widget_instance) {
+        update_labels(widget_instance, &state);
+    }
+
+#if IS_ENABLED(CONFIG_MARTEN_NICE_VIEW_LOG_MEMORY)
+    static bool memory_logged = false;
+    if (!memory_logged) {
+        // Let LVGL finish drawing the first frame before measuring.
+        lv_refr_now(NULL);
+        lvgl_print_heap_info(false);
+        log_stack_usage();
+        memory_logged = true;
+    }
+#endif
+
+    schedule_refresh(K_SECONDS(CONFIG_MARTEN_NICE_VIEW_POLL_INTERVAL_SECONDS));
+}
+
+static lv_obj_t *create_label(lv_obj_t *parent, const lv_font_t *font, lv_align_t align,
+                              int32_t width) {
+    lv_obj_t *label = lv_label_create(parent);
+
+    lv_obj_set_style_text_font(label, font, LV_PART_MAIN);
+    lv_label_set_long_mode(label, LV_LABEL_LONG_CLIP);
+    lv_label_set_text_static(label, "");
+    lv_obj_set_width(label, width);
+    lv_obj_align(label, align, 0, 0);
+
+    if (align == LV_ALIGN_TOP_RIGHT || align == LV_ALIGN_BOTTOM_RIGHT) {
+        lv_obj_set_style_text_align(label, LV_TEXT_ALIGN_RIGHT, LV_PART_MAIN);
+    }
+
+    return label;
+}
+
+int zmk_widget_power_status_init(struct zmk_widget_power_status *widget, lv_obj_t *parent) {
+    widget->obj = lv_obj_create(parent);
+    lv_obj_remove_style_all(widget->obj);
+    lv_obj_set_size(widget->obj, lv_pct(100), lv_pct(100));
+
+    widget->soc_label = create_label(widget->obj, &lv_font_montserrat_26, LV_ALIGN_TOP_LEFT, 96);
+    widget->vbus_label = create_label(widget->obj, &lv_font_montserrat_16, LV_ALIGN_TOP_RIGHT, 24);
+    widget->state_label =
+        create_label(widget->obj, &lv_font_montserrat_16, LV_ALIGN_BOTTOM_LEFT, 100);
+    widget->runtime_label =
+        create_label(widget->obj, &lv_font_montserrat_16, LV_ALIGN_BOTTOM_RIGHT, 60);
+
+    widget_instance = widget;
+    drawn = false;
+    schedule_refresh(K_NO_WAIT);
+
+    return 0;
+}
+
+lv_obj_t *zmk_widget_power_status_obj(struct zmk_widget_power_status *widget) {
+    return widget->obj;
+}
+
+static int widget_power_status_listener(const zmk_event_t *eh) {
+    schedule_refresh(K_NO_WAIT);
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(widget_power_status, widget_power_status_listener);
+#if IS_ENABLED(CONFIG_ZMK_BATTERY_REPORTING)
+ZMK_SUBSCRIPTION(widget_power_status, zmk_battery_state_changed);
+#endif
+#if IS_ENABLED(CONFIG_ZMK_USB)
+ZMK_SUBSCRIPTION(widget_power_status, zmk_usb_conn_state_changed);
+#endif
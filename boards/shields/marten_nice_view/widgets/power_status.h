@@ -0,0 +1,14 @@
+#pragma once
+
+#include <lvgl.h>
+
+struct zmk_widget_power_status {
+    lv_obj_t *obj;
+    lv_obj_t *soc_label;
+    lv_obj_t *state_label;
+    lv_obj_t *vbus_label;
+    lv_obj_t *runtime_label;
+};
+
+int zmk_widget_power_status_init(struct zmk_widget_power_status *widget, lv_obj_t *parent);
+lv_obj_t *zmk_widget_power_status_obj(struct zmk_widget_power_status *widget);
@@ -0,0 +1,272 @@
+#define DT_DRV_COMPAT zmk_behavior_sensor_rotate_batch
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+
+#include <drivers/behavior.h>
+#include <zmk/behavior.h>
+#include <zmk/behavior_queue.h>
+#include <zmk/keymap.h>
+#include <zmk/sensors.h>
+#include <zmk/virtual_key_position.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Like &inc_dec_kp, but instead of queueing a tap for every trigger as soon as
+// the encoder moves, this collects triggers for a short window and then queues
+// all of them at once.
+//
+// Each trigger is still sent as its own press and release, since a key report
+// has no way to say "pressed N times". Batching only delays the taps so they
+// are sent back-to-back, where they may share a connection event. It doesn't
+// reduce the number of reports, so the window is off by default.
+//
+// If acceleration is enabled, triggers beyond a threshold within one window are
+// multiplied, so fast spins move further than slow ones.
+//
+// Taps which don't fit in the behavior queue are kept and queued after the
+// queue has had time to drain.
+
+// Time to wait before retrying when the behavior queue is full.
+#define QUEUE_FULL_RETRY_MS 20
+
+struct behavior_sensor_rotate_batch_config {
+    struct zmk_behavior_binding cw_binding;
+    struct zmk_behavior_binding ccw_binding;
+    int tap_ms;
+    int window_ms;
+    int acceleration_threshold;
+    int acceleration_multiplier;
+};
+
+struct sensor_batch {
+    const struct device *dev;
+    struct k_work_delayable flush_work;
+    struct zmk_behavior_binding_event event;
+    struct zmk_behavior_binding binding;
+    int triggers;
+    // Taps which didn't fit in the behavior queue yet.
+    struct zmk_behavior_binding_event tap_event;
+    struct zmk_behavior_binding tap_binding;
+    int taps;
+    // The last press was queued but its release wasn't.
+    bool release_pending;
+};
+
+struct behavior_sensor_rotate_batch_data {
+    struct sensor_value remainder[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
+    int triggers[ZMK_KEYMAP_SENSORS_LEN][ZMK_KEYMAP_LAYERS_LEN];
+    struct sensor_batch batches[ZMK_KEYMAP_SENSORS_LEN];
+};
+
+static int apply_acceleration(const struct behavior_sensor_rotate_batch_config *config,
+                              int count) {
+    if (config->acceleration_threshold <= 0 || count <= config->acceleration_threshold) {
+        return count;
+    }
+
+    const int extra = count - config->acceleration_threshold;
+    return config->acceleration_threshold + extra * config->acceleration_multiplier;
+}
+
+// Queues as many of the batch's pending taps as fit in the behavior queue.
+// Returns true if all of them were queued.
+static bool queue_taps(struct sensor_batch *batch) {
+    const struct behavior_sensor_rotate_batch_config *config = batch->dev->config;
+    int ret;
+
+    // A press without its release would leave the key stuck, so always finish
+    // the previous tap first.
+    if (batch->release_pending) {
+        ret = zmk_behavior_queue_add(&batch->tap_event, batch->tap_binding, false, 0);
+        if (ret) {
+            LOG_DBG("Failed to queue release: %d", ret);
+            return false;
+        }
+
+        batch->release_pending = false;
+    }
+
+    while (batch->taps > 0) {
+        ret = zmk_behavior_queue_add(&batch->tap_event, batch->tap_binding, true, config->tap_ms);
+        if (ret) {
+            LOG_DBG("Failed to queue press: %d. %d taps remaining", ret, batch->taps);
+            return false;
+        }
+
+        batch->taps--;
+
+        ret = zmk_behavior_queue_add(&batch->tap_event, batch->tap_binding, false, 0);
+        if (ret) {
+            LOG_DBG("Failed to queue release: %d. %d taps remaining", ret, batch->taps);
+            batch->release_pending = true;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Returns true if everything in the batch was queued.
+static bool flush_batch(struct sensor_batch *batch) {
+    const struct behavior_sensor_rotate_batch_config *config = batch->dev->config;
+
+    // Finish the taps from the previous window before starting new ones, so a
+    // change of direction keeps its order.
+    if (!queue_taps(batch)) {
+        return false;
+    }
+
+    if (batch->triggers == 0) {
+        return true;
+    }
+
+    struct zmk_behavior_binding triggered_binding;
+    int count;
+
+    if (batch->triggers > 0) {
+        triggered_binding = config->cw_binding;
+        triggered_binding.param1 = batch->binding.param1;
+        count = batch->triggers;
+    } else {
+        triggered_binding = config->ccw_binding;
+        triggered_binding.param1 = batch->binding.param2;
+        count = -batch->triggers;
+    }
+
+    batch->triggers = 0;
+    count = apply_acceleration(config, count);
+
+    LOG_DBG("Sensor batch: %d x %s", count, triggered_binding.behavior_dev);
+
+    batch->tap_event = batch->event;
+    batch->tap_binding = triggered_binding;
+    batch->taps = count;
+
+    return queue_taps(batch);
+}
+
+static void flush_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct sensor_batch *batch = CONTAINER_OF(dwork, struct sensor_batch, flush_work);
+
+    if (!flush_batch(batch)) {
+        k_work_schedule(&batch->flush_work, K_MSEC(QUEUE_FULL_RETRY_MS));
+    }
+}
+
+static int accept_data(struct zmk_behavior_binding *binding,
+                       struct zmk_behavior_binding_event event,
+                       const struct zmk_sensor_config *sensor_config, size_t channel_data_size,
+                       const struct zmk_sensor_channel_data *channel_data) {
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    struct behavior_sensor_rotate_batch_data *data = dev->data;
+
+    const int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+    struct sensor_value remainder = data->remainder[sensor_index][event.layer];
+
+    remainder.val1 += channel_data[0].value.val1;
+    remainder.val2 += channel_data[0].value.val2;
+
+    remainder.val1 += remainder.val2 / 1000000;
+    remainder.val2 %= 1000000;
+
+    const int trigger_degrees = 360 / sensor_config->triggers_per_rotation;
+    const int triggers = remainder.val1 / trigger_degrees;
+    remainder.val1 %= trigger_degrees;
+
+    data->remainder[sensor_index][event.layer] = remainder;
+    data->triggers[sensor_index][event.layer] = triggers;
+
+    return 0;
+}
+
+static int process(struct zmk_behavior_binding *binding, struct zmk_behavior_binding_event event,
+                   enum behavior_sensor_binding_process_mode mode) {
+    const struct device *dev = zmk_behavior_get_binding(binding->behavior_dev);
+    const struct behavior_sensor_rotate_batch_config *config = dev->config;
+    struct behavior_sensor_rotate_batch_data *data = dev->data;
+
+    const int sensor_index = ZMK_SENSOR_POSITION_FROM_VIRTUAL_KEY_POSITION(event.position);
+    const int triggers = data->triggers[sensor_index][event.layer];
+    data->triggers[sensor_index][event.layer] = 0;
+
+    if (mode != BEHAVIOR_SENSOR_BINDING_PROCESS_MODE_TRIGGER || triggers == 0) {
+        return ZMK_BEHAVIOR_TRANSPARENT;
+    }
+
+    struct sensor_batch *batch = &data->batches[sensor_index];
+
+    // Don't let a change of direction or layer cancel out pending triggers.
+    const bool reversed = (batch->triggers > 0) != (triggers > 0);
+    if (batch->triggers != 0 && (reversed || batch->event.layer != event.layer)) {
+        k_work_cancel_delayable(&batch->flush_work);
+        if (!flush_batch(batch)) {
+            // The old triggers are now pending taps, which the retry below
+            // queues before any of the new ones.
+            k_work_schedule(&batch->flush_work, K_MSEC(QUEUE_FULL_RETRY_MS));
+        }
+    }
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT)
+    // Always trigger on central, as with the built-in sensor rotate behaviors.
+    event.source = ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL;
+#endif
+
+    batch->event = event;
+    batch->binding = *binding;
+    batch->triggers += triggers;
+
+    if (config->window_ms <= 0 && batch->taps == 0 && !batch->release_pending) {
+        if (!flush_batch(batch)) {
+            k_work_schedule(&batch->flush_work, K_MSEC(QUEUE_FULL_RETRY_MS));
+        }
+    } else {
+        // Schedule (not reschedule) so a continuous spin still flushes once per window.
+        k_work_schedule(&batch->flush_work, K_MSEC(config->window_ms));
+    }
+
+    return ZMK_BEHAVIOR_OPAQUE;
+}
+
+static int behavior_sensor_rotate_batch_init(const struct device *dev) {
+    struct behavior_sensor_rotate_batch_data *data = dev->data;
+
+    for (int i = 0; i < ARRAY_SIZE(data->batches); i++) {
+        data->batches[i].dev = dev;
+        k_work_init_delayable(&data->batches[i].flush_work, flush_work_handler);
+    }
+
+    return 0;
+}
+
+static const struct behavior_driver_api behavior_sensor_rotate_batch_driver_api = {
+    .sensor_binding_accept_data = accept_data,
+    .sensor_binding_process = process,
+};
+
+#define BATCH_BINDING(n, idx)                                                                      \
+    {.behavior_dev = DEVICE_DT_NAME(DT_INST_PHANDLE_BY_IDX(n, bindings, idx))}
+
+#define SENSOR_ROTATE_BATCH_INST(n)                                                                \
+    static const struct behavior_sensor_rotate_batch_config                                        \
+        behavior_sensor_rotate_batch_config_##n = {                                                \
+            .cw_binding = BATCH_BINDING(n, 0),                                                     \
+            .ccw_binding = BATCH_BINDING(n, 1),                                                    \
+            .tap_ms = DT_INST_PROP(n, tap_ms),                                                     \
+            .window_ms = DT_INST_PROP(n, window_ms),                                               \
+            .acceleration_threshold = DT_INST_PROP(n, acceleration_threshold),                     \
+            .acceleration_multiplier = DT_INST_PROP(n, acceleration_multiplier),                   \
+    };                                                                                             \
+                                                                                                   \
+    static struct behavior_sensor_rotate_batch_data behavior_sensor_rotate_batch_data_##n;         \
+                                                                                                   \
+    BEHAVIOR_DT_INST_DEFINE(n, behavior_sensor_rotate_batch_init, NULL,                            \
+                            &behavior_sensor_rotate_batch_data_##n,                                \
+                            &behavior_sensor_rotate_batch_config_##n, POST_KERNEL,                 \
+                            CONFIG_KERNEL_INIT_PRIORITY_DEFAULT,                                   \
+                            &behavior_sensor_rotate_batch_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(SENSOR_ROTATE_BATCH_INST)
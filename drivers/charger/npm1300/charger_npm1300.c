@@ -6,6 +6,9 @@
 #include <zephyr/drivers/sensor.h>
 #include <zephyr/drivers/sensor/npm1300_charger.h>
 #include <zephyr/kernel.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <drivers/npm1300_telemetry.h>
 
 #include <zephyr/logging/log.h>
 
@@ -32,9 +35,14 @@ LOG_MODULE_REGISTER(charger_npm1300, CONFIG_CHARGER_LOG_LEVEL);
         BIT(NPM1300_EVENT_BATTERY_DETECTED) | BIT(NPM1300_EVENT_BATTERY_REMOVED) |                 \
         BIT(NPM1300_EVENT_VBUS_DETECTED) | BIT(NPM1300_EVENT_VBUS_REMOVED)
 
+// Keep the I2C bus for a short time after each access, since properties are
+// usually read several at a time.
+#define BUS_RELEASE_DELAY K_MSEC(10)
+
 struct charger_npm1300_config {
     const struct device *mfd;
     const struct device *charger;
+    const struct device *bus;
 };
 
 struct charger_npm1300_data {
@@ -51,12 +59,18 @@ static int get_charger_channel(const struct device *dev, enum sensor_channel cha
                                struct sensor_value *val) {
     const struct charger_npm1300_config *config = dev->config;
 
-    int ret = sensor_sample_fetch(config->charger);
-    if (ret) {
+    // The nPM1300 MFD has no PM support of its own, so hold the I2C bus it
+    // uses. The bus would resume itself for each transfer, but holding it lets
+    // all transfers in a fetch share one resume.
+    int ret = pm_device_runtime_get(config->bus);
+    if (ret < 0) {
         return ret;
     }
 
-    return sensor_channel_get(config->charger, chan, val);
+    ret = npm1300_telemetry_get(config->charger, chan, val);
+
+    pm_device_runtime_put_async(config->bus, BUS_RELEASE_DELAY);
+    return ret;
 }
 
 static int get_charger_online(const struct device *dev, enum charger_online *val) {
@@ -146,28 +160,14 @@ static int charger_npm1300_set_prop(const struct device *dev, const charger_prop
     }
 }
 
-static int charger_npm1300_init_properties(const struct device *dev) {
-    struct charger_npm1300_data *data = dev->data;
-
-    int ret = get_charger_status(dev, &data->status);
-    if (ret) {
-        LOG_ERR("Failed to read charger status: %d", ret);
-        return ret;
-    }
-
-    ret = get_charger_online(dev, &data->online);
-    if (ret) {
-        LOG_ERR("Failed to read charger online: %d", ret);
-        return ret;
-    }
-
-    return 0;
-}
-
 static void charger_npm1300_interrupt_work_handler(struct k_work *work) {
     struct charger_npm1300_data *data =
         CONTAINER_OF(work, struct charger_npm1300_data, int_routine_work);
     const struct device *dev = data->dev;
+    const struct charger_npm1300_config *config = dev->config;
+
+    // The event means the cached measurements are out of date.
+    npm1300_telemetry_invalidate(config->charger);
 
     enum charger_status new_status;
     int ret = get_charger_status(dev, &new_status);
@@ -225,16 +225,21 @@ static int charger_npm1300_init(const struct device *dev) {
 
     data->dev = dev;
 
-    int ret = charger_npm1300_init_properties(dev);
+    k_work_init(&data->int_routine_work, charger_npm1300_interrupt_work_handler);
+
+    gpio_init_callback(&data->gpio_cb, charger_npm1300_interrupt_callback, CHARGE_EVENT_MASK);
+
+    const int ret = mfd_npm1300_add_callback(config->mfd, &data->gpio_cb);
     if (ret) {
         return ret;
     }
 
-    k_work_init(&data->int_routine_work, charger_npm1300_interrupt_work_handler);
-
-    gpio_init_callback(&data->gpio_cb, charger_npm1300_interrupt_callback, CHARGE_EVENT_MASK);
+    // Read the initial state after boot instead of blocking other devices'
+    // init on I2C transfers. Until then, the charger reports unknown status
+    // and offline. The notifiers are called once the real state is known.
+    k_work_submit(&data->int_routine_work);
 
-    return mfd_npm1300_add_callback(config->mfd, &data->gpio_cb);
+    return 0;
 }
 
 static DEVICE_API(charger, charger_npm1300_api) = {
@@ -247,6 +252,7 @@ static DEVICE_API(charger, charger_npm1300_api) = {
     static const struct charger_npm1300_config charger_npm1300_config_##n = {                      \
         .mfd = DEVICE_DT_GET(DT_INST_PARENT(n)),                                                   \
         .charger = DEVICE_DT_GET(DT_INST_PHANDLE(n, charger)),                                     \
+        .bus = DEVICE_DT_GET(DT_BUS(DT_INST_PARENT(n))),                                           \
     };                                                                                             \
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, charger_npm1300_init, NULL, &charger_npm1300_data_##n,                \
@@ -0,0 +1,257 @@
+#define DT_DRV_COMPAT zmk_display_page_diff
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/display.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(display_page_diff, CONFIG_DISPLAY_LOG_LEVEL);
+
+// Wraps a monochrome display with vertically tiled pages (e.g. SSD1306) and
+// keeps a copy of the last frame that was sent to it. Writes are compared
+// against the copy, and only the column ranges that changed in each page are
+// forwarded, in chunks no larger than max-transfer-bytes.
+
+#define PAGE_HEIGHT 8
+
+struct display_page_diff_config {
+    const struct device *display;
+    uint16_t width;
+    uint16_t height;
+    uint16_t max_transfer;
+    uint16_t merge_gap;
+    uint8_t *shadow;
+};
+
+struct display_page_diff_data {
+    // Bit N is set once page N of the shadow is known to match the panel.
+    uint32_t valid_pages;
+    bool passthrough;
+};
+
+static int write_run(const struct device *dev, uint16_t x, uint16_t page, const uint8_t *buf,
+                     uint16_t len) {
+    const struct display_page_diff_config *config = dev->config;
+
+    while (len > 0) {
+        const uint16_t chunk = MIN(len, config->max_transfer);
+        const struct display_buffer_descriptor desc = {
+            .buf_size = chunk,
+            .width = chunk,
+            .height = PAGE_HEIGHT,
+            .pitch = chunk,
+        };
+
+        const int ret = display_write(config->display, x, page * PAGE_HEIGHT, &desc, buf);
+        if (ret) {
+            return ret;
+        }
+
+        x += chunk;
+        buf += chunk;
+        len -= chunk;
+    }
+
+    return 0;
+}
+
+static int write_page(const struct device *dev, uint16_t x, uint16_t page, const uint8_t *buf,
+                      uint16_t width) {
+    const struct display_page_diff_config *config = dev->config;
+    struct display_page_diff_data *data = dev->data;
+    const bool force = !(data->valid_pages & BIT(page));
+    uint8_t *shadow = &config->shadow[page * config->width + x];
+
+    int run_start = -1;
+    int run_end = -1;
+
+    for (int i = 0; i < width; i++) {
+        if (!force && buf[i] == shadow[i]) {
+            continue;
+        }
+
+        // Sending a few unchanged bytes is cheaper than starting a new transfer,
+        // which has to set the address window again.
+        if (run_start >= 0 && i - run_end > config->merge_gap) {
+            const int ret = write_run(dev, x + run_start, page, &buf[run_start],
+                                      run_end - run_start + 1);
+            if (ret) {
+                return ret;
+            }
+            run_start = -1;
+        }
+
+        if (run_start < 0) {
+            run_start = i;
+        }
+        run_end = i;
+    }
+
+    if (run_start >= 0) {
+        const int ret =
+            write_run(dev, x + run_start, page, &buf[run_start], run_end - run_start + 1);
+        if (ret) {
+            return ret;
+        }
+    }
+
+    memcpy(shadow, buf, width);
+
+    if (x == 0 && width == config->width) {
+        data->valid_pages |= BIT(page);
+    }
+
+    return 0;
+}
+
+static int display_page_diff_write(const struct device *dev, const uint16_t x, const uint16_t y,
+                                   const struct display_buffer_descriptor *desc, const void *buf) {
+    const struct display_page_diff_config *config = dev->config;
+    struct display_page_diff_data *data = dev->data;
+
+    if (data->passthrough) {
+        return display_write(config->display, x, y, desc, buf);
+    }
+
+    if (y % PAGE_HEIGHT != 0 || desc->height % PAGE_HEIGHT != 0 || desc->pitch < desc->width ||
+        x + desc->width > config->width || y + desc->height > config->height) {
+        LOG_ERR("Unsupported write area %ux%u at %u,%u", desc->width, desc->height, x, y);
+        return -EINVAL;
+    }
+
+    const uint16_t first_page = y / PAGE_HEIGHT;
+    const uint16_t num_pages = desc->height / PAGE_HEIGHT;
+
+    for (int i = 0; i < num_pages; i++) {
+        const uint8_t *page_buf = (const uint8_t *)buf + i * desc->pitch;
+        const int ret = write_page(dev, x, first_page + i, page_buf, desc->width);
+        if (ret) {
+            // The panel contents are unknown now, so resend everything next time.
+            data->valid_pages = 0;
+            return ret;
+        }
+    }
+
+    return 0;
+}
+
+static int display_page_diff_read(const struct device *dev, const uint16_t x, const uint16_t y,
+                                  const struct display_buffer_descriptor *desc, void *buf) {
+    const struct display_page_diff_config *config = dev->config;
+
+    return display_read(config->display, x, y, desc, buf);
+}
+
+static void *display_page_diff_get_framebuffer(const struct device *dev) { return NULL; }
+
+static int display_page_diff_blanking_off(const struct device *dev) {
+    const struct display_page_diff_config *config = dev->config;
+
+    return display_blanking_off(config->display);
+}
+
+static int display_page_diff_blanking_on(const struct device *dev) {
+    const struct display_page_diff_config *config = dev->config;
+
+    return display_blanking_on(config->display);
+}
+
+static int display_page_diff_set_brightness(const struct device *dev, const uint8_t brightness) {
+    const struct display_page_diff_config *config = dev->config;
+
+    return display_set_brightness(config->display, brightness);
+}
+
+static int display_page_diff_set_contrast(const struct device *dev, const uint8_t contrast) {
+    const struct display_page_diff_config *config = dev->config;
+
+    return display_set_contrast(config->display, contrast);
+}
+
+static void display_page_diff_get_capabilities(const struct device *dev,
+                                               struct display_capabilities *caps) {
+    const struct display_page_diff_config *config = dev->config;
+
+    display_get_capabilities(config->display, caps);
+}
+
+static int display_page_diff_set_pixel_format(const struct device *dev,
+                                              const enum display_pixel_format pixel_format) {
+    const struct display_page_diff_config *config = dev->config;
+    struct display_page_diff_data *data = dev->data;
+
+    data->valid_pages = 0;
+    return display_set_pixel_format(config->display, pixel_format);
+}
+
+static int display_page_diff_set_orientation(const struct device *dev,
+                                             const enum display_orientation orientation) {
+    const struct display_page_diff_config *config = dev->config;
+    struct display_page_diff_data *data = dev->data;
+
+    data->valid_pages = 0;
+    return display_set_orientation(config->display, orientation);
+}
+
+static int display_page_diff_init(const struct device *dev) {
+    const struct display_page_diff_config *config = dev->config;
+    struct display_page_diff_data *data = dev->data;
+
+    if (!device_is_ready(config->display)) {
+        LOG_ERR("Display device is not ready");
+        return -ENODEV;
+    }
+
+    struct display_capabilities caps;
+    display_get_capabilities(config->display, &caps);
+
+    if (!(caps.screen_info & SCREEN_INFO_MONO_VTILED)) {
+        LOG_WRN("%s is not a vertically tiled display. Passing writes through unchanged.",
+                config->display->name);
+        data->passthrough = true;
+    }
+
+    return 0;
+}
+
+static DEVICE_API(display, display_page_diff_api) = {
+    .blanking_on = display_page_diff_blanking_on,
+    .blanking_off = display_page_diff_blanking_off,
+    .write = display_page_diff_write,
+    .read = display_page_diff_read,
+    .get_framebuffer = display_page_diff_get_framebuffer,
+    .set_brightness = display_page_diff_set_brightness,
+    .set_contrast = display_page_diff_set_contrast,
+    .get_capabilities = display_page_diff_get_capabilities,
+    .set_pixel_format = display_page_diff_set_pixel_format,
+    .set_orientation = display_page_diff_set_orientation,
+};
+
+#define TARGET_NODE(n) DT_INST_PHANDLE(n, display)
+
+#define DISPLAY_PAGE_DIFF_DEFINE(n)                                                                \
+    BUILD_ASSERT(DT_INST_PROP(n, width) == DT_PROP(TARGET_NODE(n), width) &&                       \
+                     DT_INST_PROP(n, height) == DT_PROP(TARGET_NODE(n), height),                   \
+                 "zmk,display-page-diff size must match the wrapped display");                     \
+    BUILD_ASSERT(DT_INST_PROP(n, height) / PAGE_HEIGHT <= 32,                                      \
+                 "Display has too many pages for the valid page mask");                            \
+                                                                                                   \
+    static uint8_t display_page_diff_shadow_##n[DT_INST_PROP(n, width) *                           \
+                                                DT_INST_PROP(n, height) / PAGE_HEIGHT];            \
+                                                                                                   \
+    static struct display_page_diff_data display_page_diff_data_##n;                               \
+    static const struct display_page_diff_config display_page_diff_config_##n = {                  \
+        .display = DEVICE_DT_GET(TARGET_NODE(n)),                                                  \
+        .width = DT_INST_PROP(n, width),                                                           \
+        .height = DT_INST_PROP(n, height),                                                         \
+        .max_transfer = DT_INST_PROP(n, max_transfer_bytes),                                       \
+        .merge_gap = DT_INST_PROP(n, merge_gap_bytes),                                             \
+        .shadow = display_page_diff_shadow_##n,                                                    \
+    };                                                                                             \
+                                                                                                   \
+    DEVICE_DT_INST_DEFINE(n, display_page_diff_init, NULL, &display_page_diff_data_##n,            \
+                          &display_page_diff_config_##n, POST_KERNEL,                              \
+                          CONFIG_ZMK_DISPLAY_PAGE_DIFF_INIT_PRIORITY, &display_page_diff_api);
+
+DT_INST_FOREACH_STATUS_OKAY(DISPLAY_PAGE_DIFF_DEFINE)
@@ -0,0 +1,327 @@
+#define DT_DRV_COMPAT nordic_npm1300
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/gpio/gpio_emul.h>
+#include <zephyr/drivers/i2c.h>
+#include <zephyr/drivers/i2c_emul.h>
+#include <zephyr/kernel.h>
+#include <string.h>
+
+#include <drivers/emul_npm1300.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(emul_npm1300, CONFIG_EMUL_LOG_LEVEL);
+
+// Emulates the nPM1300 register interface. Registers are addressed by a base
+// and offset byte, followed by data which auto-increments the offset.
+//
+// Most registers simply store what is written. The MAIN event registers start
+// at offset 0x02 and come in groups of four (SET, CLR, INTENSET, INTENCLR).
+// Reading SET or CLR returns the pending events, and reading INTENSET or
+// INTENCLR returns the interrupt enable mask. The host interrupt line is active
+// while any enabled event is pending. MAIN offsets 0x00 and 0x01 are plain
+// registers.
+
+#define NUM_BASES 16
+#define NUM_OFFSETS 256
+
+#define MAIN_BASE 0x00U
+#define MAIN_EVENTS_START 0x02U
+#define MAIN_GROUP_SIZE 4U
+// Groups from EVENTSADCSET (0x02) to EVENTSGPIOSET (0x22)
+#define MAIN_NUM_GROUPS 9U
+#define MAIN_OFFSET_SET 0x00U
+#define MAIN_OFFSET_CLR 0x01U
+#define MAIN_OFFSET_INTENSET 0x02U
+#define MAIN_OFFSET_INTENCLR 0x03U
+
+#define EVENT_GROUP_CHARGER_STATUS 0x0AU
+#define EVENT_CHG_COMPLETED 0x10U
+#define EVENT_GROUP_VBUS 0x16U
+#define EVENT_VBUS_DETECTED 0x01U
+#define EVENT_VBUS_REMOVED 0x02U
+
+#define VBUS_BASE 0x02U
+#define VBUS_OFFSET_STATUS 0x07U
+#define VBUS_STATUS_PRESENT 0x01U
+
+#define CHGR_BASE 0x03U
+#define CHGR_OFFSET_CHG_STAT 0x34U
+#define CHGR_STATUS_COMPLETED 0x02U
+
+// ADC result layout as read by the npm1300_charger sensor driver.
+#define ADC_BASE 0x05U
+#define ADC_OFFSET_MSB_VBAT 0x11U
+#define ADC_OFFSET_LSB_A 0x15U
+#define ADC_LSB_VBAT_MASK 0x03U
+#define ADC_VBAT_FULL_SCALE_MV 5000
+#define ADC_MAX_VALUE 1023
+
+struct emul_npm1300_config {
+    uint16_t addr;
+    struct gpio_dt_spec host_int;
+};
+
+struct emul_npm1300_data {
+    struct k_mutex lock;
+    uint8_t regs[NUM_BASES][NUM_OFFSETS];
+    uint8_t events[MAIN_NUM_GROUPS];
+    uint8_t inten[MAIN_NUM_GROUPS];
+    struct emul_npm1300_stats stats;
+};
+
+static bool is_event_reg(uint8_t base, uint8_t offset) {
+    return base == MAIN_BASE && offset >= MAIN_EVENTS_START &&
+           offset < MAIN_EVENTS_START + MAIN_NUM_GROUPS * MAIN_GROUP_SIZE;
+}
+
+static int get_event_group(uint8_t offset) {
+    return (offset - MAIN_EVENTS_START) / MAIN_GROUP_SIZE;
+}
+
+static int get_event_reg(uint8_t offset) { return (offset - MAIN_EVENTS_START) % MAIN_GROUP_SIZE; }
+
+static uint8_t read_reg(struct emul_npm1300_data *data, uint8_t base, uint8_t offset) {
+    if (is_event_reg(base, offset)) {
+        const int group = get_event_group(offset);
+
+        switch (get_event_reg(offset)) {
+        case MAIN_OFFSET_SET:
+        case MAIN_OFFSET_CLR:
+            return data->events[group];
+
+        default:
+            return data->inten[group];
+        }
+    }
+
+    return data->regs[base][offset];
+}
+
+static void write_reg(struct emul_npm1300_data *data, uint8_t base, uint8_t offset, uint8_t value) {
+    if (is_event_reg(base, offset)) {
+        const int group = get_event_group(offset);
+
+        switch (get_event_reg(offset)) {
+        case MAIN_OFFSET_SET:
+            data->events[group] |= value;
+            break;
+
+        case MAIN_OFFSET_CLR:
+            data->events[group] &= ~value;
+            break;
+
+        case MAIN_OFFSET_INTENSET:
+            data->inten[group] |= value;
+            break;
+
+        case MAIN_OFFSET_INTENCLR:
+            data->inten[group] &= ~value;
+            break;
+        }
+        return;
+    }
+
+    data->regs[base][offset] = value;
+}
+
+static bool is_interrupt_pending(const struct emul_npm1300_data *data) {
+    for (int i = 0; i < MAIN_NUM_GROUPS; i++) {
+        if (data->events[i] & data->inten[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Must be called without the lock held, since setting the pin calls the MFD's
+// interrupt callback.
+static void update_interrupt(const struct emul *target) {
+    const struct emul_npm1300_config *config = target->cfg;
+    struct emul_npm1300_data *data = target->data;
+
+    if (!config->host_int.port) {
+        return;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    const bool pending = is_interrupt_pending(data);
+    k_mutex_unlock(&data->lock);
+
+    gpio_emul_input_set(config->host_int.port, config->host_int.pin, pending ? 1 : 0);
+}
+
+static int emul_npm1300_transfer(const struct emul *target, struct i2c_msg *msgs, int num_msgs,
+                                 int addr) {
+    const struct emul_npm1300_config *config = target->cfg;
+    struct emul_npm1300_data *data = target->data;
+
+    if (addr != config->addr) {
+        return -EIO;
+    }
+
+    // Every access starts by writing the two address bytes.
+    if (num_msgs < 1 || (msgs[0].flags & I2C_MSG_READ) || msgs[0].len < 2) {
+        LOG_ERR("Transfer must start by writing a register address");
+        return -EIO;
+    }
+
+    const uint8_t base = msgs[0].buf[0];
+    uint8_t offset = msgs[0].buf[1];
+    bool wrote = false;
+
+    if (base >= NUM_BASES) {
+        LOG_ERR("Invalid register base %02x", base);
+        return -EIO;
+    }
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+
+    data->stats.transactions++;
+
+    // The MFD's interrupt work starts each run by reading all of MAIN.
+    if (base == MAIN_BASE && offset == 0 && num_msgs > 1 && (msgs[1].flags & I2C_MSG_READ)) {
+        data->stats.interrupt_work_runs++;
+    }
+
+    for (int i = 2; i < msgs[0].len; i++) {
+        write_reg(data, base, offset++, msgs[0].buf[i]);
+        data->stats.bytes_written++;
+        wrote = true;
+    }
+
+    for (int m = 1; m < num_msgs; m++) {
+        struct i2c_msg *msg = &msgs[m];
+
+        for (int i = 0; i < msg->len; i++) {
+            if (msg->flags & I2C_MSG_READ) {
+                msg->buf[i] = read_reg(data, base, offset++);
+                data->stats.bytes_read++;
+            } else {
+                write_reg(data, base, offset++, msg->buf[i]);
+                data->stats.bytes_written++;
+                wrote = true;
+            }
+        }
+    }
+
+    k_mutex_unlock(&data->lock);
+
+    if (wrote) {
+        update_interrupt(target);
+    }
+
+    return 0;
+}
+
+void emul_npm1300_set_reg(const struct emul *target, uint8_t base, uint8_t offset, uint8_t value) {
+    struct emul_npm1300_data *data = target->data;
+
+    __ASSERT_NO_MSG(base < NUM_BASES);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->regs[base][offset] = value;
+    k_mutex_unlock(&data->lock);
+}
+
+uint8_t emul_npm1300_get_reg(const struct emul *target, uint8_t base, uint8_t offset) {
+    struct emul_npm1300_data *data = target->data;
+
+    __ASSERT_NO_MSG(base < NUM_BASES);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    const uint8_t value = read_reg(data, base, offset);
+    k_mutex_unlock(&data->lock);
+
+    return value;
+}
+
+void emul_npm1300_raise_event(const struct emul *target, uint8_t group, uint8_t mask) {
+    struct emul_npm1300_data *data = target->data;
+
+    __ASSERT_NO_MSG(is_event_reg(MAIN_BASE, group) && get_event_reg(group) == MAIN_OFFSET_SET);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->events[get_event_group(group)] |= mask;
+    k_mutex_unlock(&data->lock);
+
+    update_interrupt(target);
+}
+
+void emul_npm1300_set_vbus(const struct emul *target, bool present) {
+    struct emul_npm1300_data *data = target->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    data->regs[VBUS_BASE][VBUS_OFFSET_STATUS] = present ? VBUS_STATUS_PRESENT : 0;
+    k_mutex_unlock(&data->lock);
+
+    emul_npm1300_raise_event(target, EVENT_GROUP_VBUS,
+                             present ? EVENT_VBUS_DETECTED : EVENT_VBUS_REMOVED);
+}
+
+void emul_npm1300_set_charge_status(const struct emul *target, uint8_t status) {
+    struct emul_npm1300_data *data = target->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    const uint8_t old_status = data->regs[CHGR_BASE][CHGR_OFFSET_CHG_STAT];
+    data->regs[CHGR_BASE][CHGR_OFFSET_CHG_STAT] = status;
+    k_mutex_unlock(&data->lock);
+
+    if ((status & CHGR_STATUS_COMPLETED) && !(old_status & CHGR_STATUS_COMPLETED)) {
+        emul_npm1300_raise_event(target, EVENT_GROUP_CHARGER_STATUS, EVENT_CHG_COMPLETED);
+    }
+}
+
+void emul_npm1300_set_vbat_mv(const struct emul *target, int mv) {
+    struct emul_npm1300_data *data = target->data;
+
+    const int raw = CLAMP(mv * ADC_MAX_VALUE / ADC_VBAT_FULL_SCALE_MV, 0, ADC_MAX_VALUE);
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    uint8_t *lsb = &data->regs[ADC_BASE][ADC_OFFSET_LSB_A];
+    data->regs[ADC_BASE][ADC_OFFSET_MSB_VBAT] = raw >> 2;
+    *lsb = (*lsb & ~ADC_LSB_VBAT_MASK) | (raw & ADC_LSB_VBAT_MASK);
+    k_mutex_unlock(&data->lock);
+}
+
+void emul_npm1300_get_stats(const struct emul *target, struct emul_npm1300_stats *stats) {
+    struct emul_npm1300_data *data = target->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    *stats = data->stats;
+    k_mutex_unlock(&data->lock);
+}
+
+void emul_npm1300_reset_stats(const struct emul *target) {
+    struct emul_npm1300_data *data = target->data;
+
+    k_mutex_lock(&data->lock, K_FOREVER);
+    memset(&data->stats, 0, sizeof(data->stats));
+    k_mutex_unlock(&data->lock);
+}
+
+static int emul_npm1300_init(const struct emul *target, const struct device *parent) {
+    struct emul_npm1300_data *data = target->data;
+
+    k_mutex_init(&data->lock);
+    return 0;
+}
+
+static const struct i2c_emul_api emul_npm1300_api = {
+    .transfer = emul_npm1300_transfer,
+};
+
+#define EMUL_NPM1300_DEFINE(n)                                                                     \
+    static struct emul_npm1300_data emul_npm1300_data_##n;                                         \
+    static const struct emul_npm1300_config emul_npm1300_config_##n = {                            \
+        .addr = DT_INST_REG_ADDR(n),                                                               \
+        .host_int = GPIO_DT_SPEC_INST_GET_OR(n, host_int_gpios, {0}),                              \
+    };                                                                                             \
+                                                                                                   \
+    EMUL_DT_INST_DEFINE(n, emul_npm1300_init, &emul_npm1300_data_##n, &emul_npm1300_config_##n,    \
+                        &emul_npm1300_api, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(EMUL_NPM1300_DEFINE)
@@ -0,0 +1,441 @@
+#define DT_DRV_COMPAT zmk_nrf_gpiote_encoder
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+#include <string.h>
+
+#include <hal/nrf_gpio.h>
+#include <hal/nrf_timer.h>
+#include <helpers/nrfx_gppi.h>
+#include <nrfx_gpiote.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(zmk_nrf_gpiote_encoder, CONFIG_SENSOR_LOG_LEVEL);
+
+// Decodes a quadrature encoder in hardware without waking the CPU on every edge.
+//
+// Edges on both pins generate GPIOTE events. Whether an edge moves the encoder
+// forward or backward depends only on which pin changed and on whether the pins
+// were equal before it changed:
+//
+//   A and B equal:     A edge -> forward, B edge -> backward
+//   A and B different: A edge -> backward, B edge -> forward
+//
+// Every edge flips that parity, so PPI tracks it with two channel groups, one
+// per parity, with only one enabled at a time. Each edge triggers COUNT on one
+// of two TIMERs in counter mode (one for each direction), disables its own
+// group, and enables the other one. The difference between the two counters is
+// the encoder position, and contact bounce cancels out, since each bounce moves
+// one step forward and one step back.
+//
+// The CPU only handles the first A edge after the encoder has been still. After
+// that, the counters are sampled periodically until they stop changing, and
+// then the first-edge interrupt is armed again.
+
+#define FULL_ROTATION 360
+
+enum {
+    GROUP_EQUAL,
+    GROUP_DIFFERENT,
+    GROUP_COUNT,
+};
+
+enum {
+    PIN_A,
+    PIN_B,
+    PIN_COUNT,
+};
+
+enum {
+    COUNTER_FORWARD,
+    COUNTER_BACKWARD,
+    COUNTER_COUNT,
+};
+
+// Each group has a counting channel and a group switching channel for each pin.
+#define PPI_CHANNEL_COUNT (GROUP_COUNT * PIN_COUNT * 2)
+
+struct nrf_gpiote_encoder_config {
+    nrfx_gpiote_t gpiote;
+    struct gpio_dt_spec a;
+    struct gpio_dt_spec b;
+    uint32_t a_pin;
+    uint32_t b_pin;
+    NRF_TIMER_Type *timers[COUNTER_COUNT];
+    k_timeout_t sample_period;
+    int32_t steps;
+};
+
+struct nrf_gpiote_encoder_data {
+    const struct device *dev;
+    struct k_work_delayable sample_work;
+    sensor_trigger_handler_t handler;
+    const struct sensor_trigger *trigger;
+    uint8_t gpiote_channels[PIN_COUNT];
+    uint8_t ppi_channels[PPI_CHANNEL_COUNT];
+    nrfx_gppi_channel_group_t groups[GROUP_COUNT];
+    uint32_t last_counts[COUNTER_COUNT];
+    int32_t pending;
+    int32_t position;
+};
+
+static uint32_t read_counter(NRF_TIMER_Type *timer) {
+    nrf_timer_task_trigger(timer, nrf_timer_capture_task_get(NRF_TIMER_CC_CHANNEL0));
+    return nrf_timer_cc_get(timer, NRF_TIMER_CC_CHANNEL0);
+}
+
+static int get_parity_group(const struct nrf_gpiote_encoder_config *config) {
+    const bool a = nrf_gpio_pin_read(config->a_pin);
+    const bool b = nrf_gpio_pin_read(config->b_pin);
+
+    return a == b ? GROUP_EQUAL : GROUP_DIFFERENT;
+}
+
+// Enables the group that matches the current pin states. This must only be
+// called while the encoder is still, or an edge could be counted in the wrong
+// direction.
+static void sync_parity_group(const struct device *dev) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+    const int group = get_parity_group(config);
+
+    nrfx_gppi_group_disable(data->groups[!group]);
+    nrfx_gppi_group_enable(data->groups[group]);
+}
+
+static void arm_first_edge_interrupt(const struct nrf_gpiote_encoder_config *config) {
+    nrfx_gpiote_trigger_disable(&config->gpiote, config->a_pin);
+    nrfx_gpiote_trigger_enable(&config->gpiote, config->a_pin, true);
+}
+
+static void disarm_first_edge_interrupt(const struct nrf_gpiote_encoder_config *config) {
+    // Keep the GPIOTE event enabled for PPI, but stop interrupting the CPU.
+    nrfx_gpiote_trigger_disable(&config->gpiote, config->a_pin);
+    nrfx_gpiote_trigger_enable(&config->gpiote, config->a_pin, false);
+}
+
+static void nrf_gpiote_encoder_edge_handler(nrfx_gpiote_pin_t pin, nrfx_gpiote_trigger_t trigger,
+                                            void *context) {
+    const struct device *dev = context;
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    disarm_first_edge_interrupt(config);
+    k_work_reschedule(&data->sample_work, config->sample_period);
+}
+
+static void nrf_gpiote_encoder_sample_work_handler(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct nrf_gpiote_encoder_data *data =
+        CONTAINER_OF(dwork, struct nrf_gpiote_encoder_data, sample_work);
+    const struct device *dev = data->dev;
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+
+    uint32_t counts[COUNTER_COUNT];
+    bool changed = false;
+
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        counts[i] = read_counter(config->timers[i]);
+        changed |= counts[i] != data->last_counts[i];
+    }
+
+    if (!changed) {
+        // The encoder is still, so this is a safe time to correct the parity
+        // group if the hardware ever missed an edge.
+        sync_parity_group(dev);
+        arm_first_edge_interrupt(config);
+
+        // An edge could have arrived between reading the counters and arming
+        // the interrupt. Check again so it isn't missed.
+        if (read_counter(config->timers[COUNTER_FORWARD]) == counts[COUNTER_FORWARD] &&
+            read_counter(config->timers[COUNTER_BACKWARD]) == counts[COUNTER_BACKWARD]) {
+            return;
+        }
+
+        disarm_first_edge_interrupt(config);
+    } else {
+        const uint32_t forward = counts[COUNTER_FORWARD] - data->last_counts[COUNTER_FORWARD];
+        const uint32_t backward = counts[COUNTER_BACKWARD] - data->last_counts[COUNTER_BACKWARD];
+        const int32_t delta = (int32_t)(forward - backward);
+
+        memcpy(data->last_counts, counts, sizeof(counts));
+
+        // Bounce without any net movement changes both counters equally.
+        if (delta != 0) {
+            data->pending += delta;
+
+            if (data->handler) {
+                data->handler(dev, data->trigger);
+            }
+        }
+    }
+
+    k_work_reschedule(&data->sample_work, config->sample_period);
+}
+
+static int nrf_gpiote_encoder_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_ROTATION) {
+        return -ENOTSUP;
+    }
+
+    data->position = data->pending;
+    data->pending = 0;
+    return 0;
+}
+
+static int nrf_gpiote_encoder_channel_get(const struct device *dev, enum sensor_channel chan,
+                                          struct sensor_value *val) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    const struct nrf_gpiote_encoder_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_ROTATION) {
+        return -ENOTSUP;
+    }
+
+    const int32_t degrees = data->position * FULL_ROTATION;
+
+    val->val1 = degrees / config->steps;
+    val->val2 = (degrees % config->steps) * 1000000 / config->steps;
+    return 0;
+}
+
+static int nrf_gpiote_encoder_trigger_set(const struct device *dev,
+                                          const struct sensor_trigger *trig,
+                                          sensor_trigger_handler_t handler) {
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    if (trig->type != SENSOR_TRIG_DATA_READY) {
+        return -ENOTSUP;
+    }
+
+    data->trigger = trig;
+    data->handler = handler;
+    return 0;
+}
+
+static void nrf_gpiote_encoder_start(const struct device *dev) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        data->last_counts[i] = read_counter(config->timers[i]);
+        nrf_timer_task_trigger(config->timers[i], NRF_TIMER_TASK_START);
+    }
+
+    sync_parity_group(dev);
+
+    nrfx_gpiote_trigger_enable(&config->gpiote, config->b_pin, false);
+    arm_first_edge_interrupt(config);
+}
+
+static void nrf_gpiote_encoder_stop(const struct device *dev) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    nrfx_gpiote_trigger_disable(&config->gpiote, config->a_pin);
+    nrfx_gpiote_trigger_disable(&config->gpiote, config->b_pin);
+
+    for (int i = 0; i < GROUP_COUNT; i++) {
+        nrfx_gppi_group_disable(data->groups[i]);
+    }
+
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        nrf_timer_task_trigger(config->timers[i], NRF_TIMER_TASK_STOP);
+    }
+
+    k_work_cancel_delayable(&data->sample_work);
+}
+
+#if IS_ENABLED(CONFIG_PM_DEVICE)
+
+static int nrf_gpiote_encoder_pm_action(const struct device *dev, enum pm_device_action action) {
+    switch (action) {
+    case PM_DEVICE_ACTION_SUSPEND:
+        nrf_gpiote_encoder_stop(dev);
+        return 0;
+
+    case PM_DEVICE_ACTION_RESUME:
+        nrf_gpiote_encoder_start(dev);
+        return 0;
+
+    default:
+        return -ENOTSUP;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_PM_DEVICE)
+
+static nrf_gpio_pin_pull_t get_pull_config(const struct gpio_dt_spec *spec) {
+    if (spec->dt_flags & GPIO_PULL_UP) {
+        return NRF_GPIO_PIN_PULLUP;
+    }
+    if (spec->dt_flags & GPIO_PULL_DOWN) {
+        return NRF_GPIO_PIN_PULLDOWN;
+    }
+    return NRF_GPIO_PIN_NOPULL;
+}
+
+static int configure_input(const struct device *dev, const struct gpio_dt_spec *spec, uint32_t pin,
+                           uint8_t *channel, bool interrupt) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+
+    nrfx_err_t err = nrfx_gpiote_channel_alloc(&config->gpiote, channel);
+    if (err != NRFX_SUCCESS) {
+        LOG_ERR("Failed to allocate GPIOTE channel: %08x", err);
+        return -ENOMEM;
+    }
+
+    const nrf_gpio_pin_pull_t pull_config = get_pull_config(spec);
+    const nrfx_gpiote_trigger_config_t trigger_config = {
+        .trigger = NRFX_GPIOTE_TRIGGER_TOGGLE,
+        .p_in_channel = channel,
+    };
+    const nrfx_gpiote_handler_config_t handler_config = {
+        .handler = nrf_gpiote_encoder_edge_handler,
+        .p_context = (void *)dev,
+    };
+    const nrfx_gpiote_input_pin_config_t input_config = {
+        .p_pull_config = &pull_config,
+        .p_trigger_config = &trigger_config,
+        .p_handler_config = interrupt ? &handler_config : NULL,
+    };
+
+    err = nrfx_gpiote_input_configure(&config->gpiote, pin, &input_config);
+    if (err != NRFX_SUCCESS) {
+        LOG_ERR("Failed to configure pin %u: %08x", pin, err);
+        return -EIO;
+    }
+
+    return 0;
+}
+
+static uint32_t group_task_address(nrfx_gppi_channel_group_t group, bool enable) {
+    return nrfx_gppi_task_address_get(enable ? nrfx_gppi_group_enable_task_get(group)
+                                             : nrfx_gppi_group_disable_task_get(group));
+}
+
+static int configure_ppi(const struct device *dev) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    for (int i = 0; i < PPI_CHANNEL_COUNT; i++) {
+        if (nrfx_gppi_channel_alloc(&data->ppi_channels[i]) != NRFX_SUCCESS) {
+            LOG_ERR("Failed to allocate PPI channel");
+            return -ENOMEM;
+        }
+    }
+
+    for (int i = 0; i < GROUP_COUNT; i++) {
+        if (nrfx_gppi_group_alloc(&data->groups[i]) != NRFX_SUCCESS) {
+            LOG_ERR("Failed to allocate PPI channel group");
+            return -ENOMEM;
+        }
+    }
+
+    const uint32_t pins[PIN_COUNT] = {config->a_pin, config->b_pin};
+    const uint8_t *channel = data->ppi_channels;
+
+    for (int group = 0; group < GROUP_COUNT; group++) {
+        const nrfx_gppi_channel_group_t own_group = data->groups[group];
+        const nrfx_gppi_channel_group_t other_group = data->groups[!group];
+
+        for (int pin = 0; pin < PIN_COUNT; pin++) {
+            const uint32_t event = nrfx_gpiote_in_event_address_get(&config->gpiote, pins[pin]);
+
+            // A moves forward when the pins are equal, and B when they are different.
+            const bool forward = (pin == PIN_A) == (group == GROUP_EQUAL);
+            NRF_TIMER_Type *timer = config->timers[forward ? COUNTER_FORWARD : COUNTER_BACKWARD];
+
+            const uint8_t count_channel = *channel++;
+            const uint8_t switch_channel = *channel++;
+
+            const uint32_t count_task = nrf_timer_task_address_get(timer, NRF_TIMER_TASK_COUNT);
+
+            nrfx_gppi_channel_endpoints_setup(count_channel, event, count_task);
+            nrfx_gppi_fork_endpoint_setup(count_channel, group_task_address(own_group, false));
+            nrfx_gppi_channel_endpoints_setup(switch_channel, event,
+                                              group_task_address(other_group, true));
+
+            nrfx_gppi_channels_include_in_group(BIT(count_channel) | BIT(switch_channel),
+                                                own_group);
+        }
+    }
+
+    return 0;
+}
+
+static int nrf_gpiote_encoder_init(const struct device *dev) {
+    const struct nrf_gpiote_encoder_config *config = dev->config;
+    struct nrf_gpiote_encoder_data *data = dev->data;
+
+    if (!gpio_is_ready_dt(&config->a) || !gpio_is_ready_dt(&config->b)) {
+        LOG_ERR("GPIO device is not ready");
+        return -ENODEV;
+    }
+
+    data->dev = dev;
+    k_work_init_delayable(&data->sample_work, nrf_gpiote_encoder_sample_work_handler);
+
+    int ret = configure_input(dev, &config->a, config->a_pin, &data->gpiote_channels[PIN_A], true);
+    if (ret) {
+        return ret;
+    }
+
+    ret = configure_input(dev, &config->b, config->b_pin, &data->gpiote_channels[PIN_B], false);
+    if (ret) {
+        return ret;
+    }
+
+    for (int i = 0; i < COUNTER_COUNT; i++) {
+        nrf_timer_mode_set(config->timers[i], NRF_TIMER_MODE_LOW_POWER_COUNTER);
+        nrf_timer_bit_width_set(config->timers[i], NRF_TIMER_BIT_WIDTH_32);
+        nrf_timer_task_trigger(config->timers[i], NRF_TIMER_TASK_CLEAR);
+    }
+
+    ret = configure_ppi(dev);
+    if (ret) {
+        return ret;
+    }
+
+    nrf_gpiote_encoder_start(dev);
+    return 0;
+}
+
+static DEVICE_API(sensor, nrf_gpiote_encoder_api) = {
+    .sample_fetch = nrf_gpiote_encoder_sample_fetch,
+    .channel_get = nrf_gpiote_encoder_channel_get,
+    .trigger_set = nrf_gpiote_encoder_trigger_set,
+};
+
+#define ENCODER_TIMER(n, idx)                                                                      \
+    ((NRF_TIMER_Type *)DT_REG_ADDR(DT_INST_PHANDLE_BY_IDX(n, timers, idx)))
+
+#define NRF_GPIOTE_ENCODER_DEFINE(n)                                                               \
+    BUILD_ASSERT(DT_INST_PROP_LEN(n, timers) == COUNTER_COUNT,                                     \
+                 "zmk,nrf-gpiote-encoder needs exactly two timers");                               \
+                                                                                                   \
+    static struct nrf_gpiote_encoder_data nrf_gpiote_encoder_data_##n;                             \
+    static const struct nrf_gpiote_encoder_config nrf_gpiote_encoder_config_##n = {                \
+        .gpiote = NRFX_GPIOTE_INSTANCE(NRF_DT_GPIOTE_INST(DT_DRV_INST(n), a_gpios)),               \
+        .a = GPIO_DT_SPEC_INST_GET(n, a_gpios),                                                    \
+        .b = GPIO_DT_SPEC_INST_GET(n, b_gpios),                                                    \
+        .a_pin = NRF_DT_GPIOS_TO_PSEL(DT_DRV_INST(n), a_gpios),                                    \
+        .b_pin = NRF_DT_GPIOS_TO_PSEL(DT_DRV_INST(n), b_gpios),                                    \
+        .timers = {ENCODER_TIMER(n, 0), ENCODER_TIMER(n, 1)},                                      \
+        .sample_period = K_MSEC(DT_INST_PROP(n, sample_period_ms)),                                \
+        .steps = DT_INST_PROP(n, steps),                                                           \
+    };                                                                                             \
+                                                                                                   \
+    PM_DEVICE_DT_INST_DEFINE(n, nrf_gpiote_encoder_pm_action);                                     \
+                                                                                                   \
+    SENSOR_DEVICE_DT_INST_DEFINE(n, nrf_gpiote_encoder_init, PM_DEVICE_DT_INST_GET(n),             \
+                                 &nrf_gpiote_encoder_data_##n, &nrf_gpiote_encoder_config_##n,     \
+                                 POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,                         \
+                                 &nrf_gpiote_encoder_api);
+
+DT_INST_FOREACH_STATUS_OKAY(NRF_GPIOTE_ENCODER_DEFINE)
@@ -0,0 +1,239 @@
+#define DT_DRV_COMPAT zmk_nrf_qdec
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/pinctrl.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/irq.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+
+#include <hal/nrf_qdec.h>
+#include <nrfx_qdec.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(zmk_nrf_qdec, CONFIG_SENSOR_LOG_LEVEL);
+
+// The nRF52 only has one QDEC peripheral.
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 1, "Only one QDEC instance is supported");
+
+#define FULL_ROTATION 360
+
+struct nrf_qdec_config {
+    nrfx_qdec_t qdec;
+    const struct pinctrl_dev_config *pcfg;
+    nrf_qdec_sampleper_t sample_period;
+    nrf_qdec_sampleper_t idle_sample_period;
+    nrf_qdec_reportper_t report_period;
+    uint32_t led_pre_us;
+    bool debounce;
+    int32_t steps;
+};
+
+struct nrf_qdec_data {
+    const struct device *dev;
+    struct k_work trigger_work;
+    sensor_trigger_handler_t handler;
+    const struct sensor_trigger *trigger;
+    atomic_t pending;
+    int32_t position;
+    bool idle;
+    bool suspended;
+};
+
+static int nrf_qdec_sample_fetch(const struct device *dev, enum sensor_channel chan) {
+    struct nrf_qdec_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_ALL && chan != SENSOR_CHAN_ROTATION) {
+        return -ENOTSUP;
+    }
+
+    data->position = (int32_t)atomic_clear(&data->pending);
+    return 0;
+}
+
+static int nrf_qdec_channel_get(const struct device *dev, enum sensor_channel chan,
+                                struct sensor_value *val) {
+    const struct nrf_qdec_config *config = dev->config;
+    const struct nrf_qdec_data *data = dev->data;
+
+    if (chan != SENSOR_CHAN_ROTATION) {
+        return -ENOTSUP;
+    }
+
+    const int32_t degrees = data->position * FULL_ROTATION;
+
+    val->val1 = degrees / config->steps;
+    val->val2 = (degrees % config->steps) * 1000000 / config->steps;
+    return 0;
+}
+
+static int nrf_qdec_trigger_set(const struct device *dev, const struct sensor_trigger *trig,
+                                sensor_trigger_handler_t handler) {
+    struct nrf_qdec_data *data = dev->data;
+
+    if (trig->type != SENSOR_TRIG_DATA_READY) {
+        return -ENOTSUP;
+    }
+
+    data->trigger = trig;
+    data->handler = handler;
+    return 0;
+}
+
+static void nrf_qdec_trigger_work_handler(struct k_work *work) {
+    struct nrf_qdec_data *data = CONTAINER_OF(work, struct nrf_qdec_data, trigger_work);
+
+    if (data->handler) {
+        data->handler(data->dev, data->trigger);
+    }
+}
+
+static void nrf_qdec_event_handler(nrfx_qdec_event_t event, void *context) {
+    const struct device *dev = context;
+    struct nrf_qdec_data *data = dev->data;
+
+    if (event.type != NRF_QDEC_EVENT_REPORTRDY || event.data.report.acc == 0) {
+        return;
+    }
+
+    atomic_add(&data->pending, event.data.report.acc);
+    k_work_submit(&data->trigger_work);
+}
+
+static void nrf_qdec_set_idle(const struct device *dev, bool idle) {
+    const struct nrf_qdec_config *config = dev->config;
+    struct nrf_qdec_data *data = dev->data;
+
+    if (data->idle == idle) {
+        return;
+    }
+
+    LOG_DBG("Sample period: %s", idle ? "idle" : "active");
+
+    // The sample period can only be changed while the QDEC is stopped.
+    nrfx_qdec_disable(&config->qdec);
+    nrf_qdec_sampleper_set(config->qdec.p_reg,
+                           idle ? config->idle_sample_period : config->sample_period);
+
+    if (!data->suspended) {
+        nrfx_qdec_enable(&config->qdec);
+    }
+
+    data->idle = idle;
+}
+
+#if IS_ENABLED(CONFIG_PM_DEVICE)
+
+static int nrf_qdec_pm_action(const struct device *dev, enum pm_device_action action) {
+    const struct nrf_qdec_config *config = dev->config;
+    struct nrf_qdec_data *data = dev->data;
+    int ret;
+
+    switch (action) {
+    case PM_DEVICE_ACTION_SUSPEND:
+        data->suspended = true;
+        nrfx_qdec_disable(&config->qdec);
+        return pinctrl_apply_state(config->pcfg, PINCTRL_STATE_SLEEP);
+
+    case PM_DEVICE_ACTION_RESUME:
+        ret = pinctrl_apply_state(config->pcfg, PINCTRL_STATE_DEFAULT);
+        if (ret) {
+            return ret;
+        }
+
+        data->suspended = false;
+        nrfx_qdec_enable(&config->qdec);
+        return 0;
+
+    default:
+        return -ENOTSUP;
+    }
+}
+
+#endif // IS_ENABLED(CONFIG_PM_DEVICE)
+
+static int nrf_qdec_init(const struct device *dev) {
+    const struct nrf_qdec_config *config = dev->config;
+    struct nrf_qdec_data *data = dev->data;
+
+    data->dev = dev;
+    k_work_init(&data->trigger_work, nrf_qdec_trigger_work_handler);
+
+    IRQ_CONNECT(DT_INST_IRQN(0), DT_INST_IRQ(0, priority), nrfx_isr, nrfx_qdec_0_irq_handler, 0);
+
+    int ret = pinctrl_apply_state(config->pcfg, PINCTRL_STATE_DEFAULT);
+    if (ret) {
+        return ret;
+    }
+
+    const nrfx_qdec_config_t qdec_config = {
+        .reportper = config->report_period,
+        .sampleper = config->sample_period,
+        .psela = NRF_QDEC_PIN_NOT_CONNECTED,
+        .pselb = NRF_QDEC_PIN_NOT_CONNECTED,
+        .pselled = NRF_QDEC_PIN_NOT_CONNECTED,
+        .ledpre = config->led_pre_us,
+        .ledpol = NRF_QDEC_LEPOL_ACTIVE_HIGH,
+        .dbfen = config->debounce,
+        .sample_inten = false,
+        .interrupt_priority = DT_INST_IRQ(0, priority),
+        .skip_gpio_cfg = true,
+        .skip_psel_cfg = true,
+    };
+
+    nrfx_err_t err = nrfx_qdec_init(&config->qdec, &qdec_config, nrf_qdec_event_handler,
+                                    (void *)dev);
+    if (err != NRFX_SUCCESS) {
+        LOG_ERR("Failed to initialize QDEC: %08x", err);
+        return -EBUSY;
+    }
+
+    nrfx_qdec_enable(&config->qdec);
+    return 0;
+}
+
+static DEVICE_API(sensor, nrf_qdec_api) = {
+    .sample_fetch = nrf_qdec_sample_fetch,
+    .channel_get = nrf_qdec_channel_get,
+    .trigger_set = nrf_qdec_trigger_set,
+};
+
+static int nrf_qdec_event_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    if (ev) {
+        nrf_qdec_set_idle(DEVICE_DT_INST_GET(0), ev->state != ZMK_ACTIVITY_ACTIVE);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(nrf_qdec, nrf_qdec_event_listener);
+ZMK_SUBSCRIPTION(nrf_qdec, zmk_activity_state_changed);
+
+// The enum values in the binding are listed in register order, so the index of
+// the selected value is also the register value.
+#define NRF_QDEC_DEFINE(n)                                                                         \
+    PINCTRL_DT_INST_DEFINE(n);                                                                     \
+                                                                                                   \
+    static struct nrf_qdec_data nrf_qdec_data_##n;                                                 \
+    static const struct nrf_qdec_config nrf_qdec_config_##n = {                                    \
+        .qdec = NRFX_QDEC_INSTANCE(0),                                                             \
+        .pcfg = PINCTRL_DT_INST_DEV_CONFIG_GET(n),                                                 \
+        .sample_period = DT_INST_ENUM_IDX(n, sample_period_us),                                    \
+        .idle_sample_period = DT_INST_ENUM_IDX(n, idle_sample_period_us),                          \
+        .report_period = DT_INST_ENUM_IDX(n, report_period),                                       \
+        .led_pre_us = DT_INST_PROP(n, led_pre_us),                                                 \
+        .debounce = DT_INST_PROP(n, debounce),                                                     \
+        .steps = DT_INST_PROP(n, steps),                                                           \
+    };                                                                                             \
+                                                                                                   \
+    PM_DEVICE_DT_INST_DEFINE(n, nrf_qdec_pm_action);                                               \
+                                                                                                   \
+    SENSOR_DEVICE_DT_INST_DEFINE(n, nrf_qdec_init, PM_DEVICE_DT_INST_GET(n), &nrf_qdec_data_##n,   \
+                                 &nrf_qdec_config_##n, POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,   \
+                                 &nrf_qdec_api);
+
+DT_INST_FOREACH_STATUS_OKAY(NRF_QDEC_DEFINE)
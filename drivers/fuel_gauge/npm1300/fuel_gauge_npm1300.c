@@ -6,6 +6,9 @@
 #include <zephyr/drivers/sensor/npm1300_charger.h>
 #include <zephyr/drivers/mfd/npm1300.h>
 #include <zephyr/kernel.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <drivers/npm1300_telemetry.h>
 
 #include <zephyr/logging/log.h>
 
@@ -20,9 +23,15 @@ LOG_MODULE_REGISTER(fuel_gauge_npm1300, CONFIG_FUEL_GAUGE_LOG_LEVEL);
 #define STATUS_DIE_TEMP_HIGH 0x40
 #define STATUS_SUPPLEMENT_ACTIVE 0x80
 
+// Keep the I2C bus for a short time after each access, since properties are
+// usually read several at a time.
+#define BUS_RELEASE_DELAY K_MSEC(10)
+
 struct fuel_gauge_npm1300_config {
     const struct device *mfd;
     const struct device *charger;
+    const struct device *bus;
+    uint32_t capacity_uah;
     // TODO: add method to set battery profile
 };
 
@@ -30,12 +39,18 @@ static int get_charger_channel(const struct device *dev, enum sensor_channel cha
                                struct sensor_value *val) {
     const struct fuel_gauge_npm1300_config *config = dev->config;
 
-    int ret = sensor_sample_fetch(config->charger);
-    if (ret) {
+    // The nPM1300 MFD has no PM support of its own, so hold the I2C bus it
+    // uses. The bus would resume itself for each transfer, but holding it lets
+    // all transfers in a fetch share one resume.
+    int ret = pm_device_runtime_get(config->bus);
+    if (ret < 0) {
         return ret;
     }
 
-    return sensor_channel_get(config->charger, chan, val);
+    ret = npm1300_telemetry_get(config->charger, chan, val);
+
+    pm_device_runtime_put_async(config->bus, BUS_RELEASE_DELAY);
+    return ret;
 }
 
 static int get_avg_current(const struct device *dev, union fuel_gauge_prop_val *val) {
@@ -101,6 +116,37 @@ static int get_battery_percent(const struct device *dev, union fuel_gauge_prop_v
     return 0;
 }
 
+static int get_runtime_to_empty(const struct device *dev, union fuel_gauge_prop_val *val) {
+    const struct fuel_gauge_npm1300_config *config = dev->config;
+
+    if (config->capacity_uah == 0) {
+        return -ENOTSUP;
+    }
+
+    union fuel_gauge_prop_val current;
+    int ret = get_avg_current(dev, &current);
+    if (ret) {
+        return ret;
+    }
+
+    // Discharge current is negative. There is no time to empty while charging.
+    if (current.avg_current >= 0) {
+        return -ENODATA;
+    }
+
+    union fuel_gauge_prop_val percent;
+    ret = get_battery_percent(dev, &percent);
+    if (ret) {
+        return ret;
+    }
+
+    const uint64_t remaining_uah =
+        (uint64_t)config->capacity_uah * percent.absolute_state_of_charge / 100;
+
+    val->runtime_to_empty = remaining_uah * 60 / -current.avg_current;
+    return 0;
+}
+
 static int fuel_gauge_npm1300_get_prop(const struct device *dev, fuel_gauge_prop_t prop,
                                        union fuel_gauge_prop_val *val) {
     switch (prop) {
@@ -117,6 +163,9 @@ static int fuel_gauge_npm1300_get_prop(const struct device *dev, fuel_gauge_prop
     case FUEL_GAUGE_VOLTAGE:
         return get_battery_voltage(dev, val);
 
+    case FUEL_GAUGE_RUNTIME_TO_EMPTY:
+        return get_runtime_to_empty(dev, val);
+
     default:
         return -ENOTSUP;
     }
@@ -152,6 +201,8 @@ static DEVICE_API(fuel_gauge, fuel_gauge_npm1300_api) = {
     static const struct fuel_gauge_npm1300_config fuel_gauge_npm1300_config##n = {                 \
         .mfd = DEVICE_DT_GET(DT_INST_PARENT(n)),                                                   \
         .charger = DEVICE_DT_GET(DT_INST_PHANDLE(n, charger)),                                     \
+        .bus = DEVICE_DT_GET(DT_BUS(DT_INST_PARENT(n))),                                           \
+        .capacity_uah = DT_INST_PROP_OR(n, capacity_microamp_hours, 0),                            \
     };                                                                                             \
                                                                                                    \
     DEVICE_DT_INST_DEFINE(n, fuel_gauge_npm1300_init, NULL, NULL, &fuel_gauge_npm1300_config##n,   \
@@ -5,6 +5,7 @@
 #include <zephyr/kernel.h>
 #include <zephyr/drivers/led.h>
 #include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
 
 #include <zmk/event_manager.h>
 #include <zmk/hid_indicators.h>
@@ -19,6 +20,8 @@ LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
 struct indicator_led_child_config {
     size_t num_leds;
     const struct led_dt_spec *leds;
+    // Devices which must be active while the LEDs are lit, e.g. PWM controllers.
+    const struct device *const *pm_devs;
 
     zmk_hid_indicators_t indicator;
     uint8_t active_brightness;
@@ -36,6 +39,10 @@ struct indicator_led_data {
     zmk_hid_indicators_t indicators;
     bool usb_powered;
     bool pm_suspended;
+    // The device holds a runtime PM reference on itself while the keyboard is awake.
+    bool runtime_held;
+    // Bit N is set if indicator N holds references on its pm_devs.
+    uint32_t held_mask;
 };
 
 static bool is_led_disabled(const struct indicator_led_child_config *config,
@@ -75,9 +82,39 @@ static uint8_t get_brightness(const struct indicator_led_child_config *config,
     return active ? config->active_brightness : config->inactive_brightness;
 }
 
+static void hold_pm_devs(const struct indicator_led_child_config *config) {
+    for (int i = 0; i < config->num_leds; i++) {
+        const int err = pm_device_runtime_get(config->pm_devs[i]);
+        if (err < 0) {
+            LOG_ERR("Failed to resume %s: %d", config->pm_devs[i]->name, err);
+        }
+    }
+}
+
+static void release_pm_devs(const struct indicator_led_child_config *config) {
+    for (int i = 0; i < config->num_leds; i++) {
+        const int err = pm_device_runtime_put(config->pm_devs[i]);
+        if (err < 0) {
+            LOG_ERR("Failed to suspend %s: %d", config->pm_devs[i]->name, err);
+        }
+    }
+}
+
 static int update_indicator(const struct indicator_led_child_config *config,
-                            const struct indicator_led_data *data) {
+                            struct indicator_led_data *data, int index) {
     const uint8_t value = get_brightness(config, data);
+    const bool held = (data->held_mask & BIT(index)) != 0;
+
+    // The LED controllers only need to be active while an LED is lit. If they
+    // aren't held, the LEDs were already turned off.
+    if (value == 0 && !held) {
+        return 0;
+    }
+
+    if (value > 0 && !held) {
+        hold_pm_devs(config);
+        data->held_mask |= BIT(index);
+    }
 
     for (int i = 0; i < config->num_leds; i++) {
         const struct led_dt_spec *spec = &config->leds[i];
@@ -88,19 +125,20 @@ static int update_indicator(const struct indicator_led_child_config *config,
         }
     }
 
+    if (value == 0 && held) {
+        release_pm_devs(config);
+        data->held_mask &= ~BIT(index);
+    }
+
     return 0;
 }
 
-static int update_device(const struct device *dev) {
+static int update_leds(const struct device *dev) {
     const struct indicator_led_config *config = dev->config;
     struct indicator_led_data *data = dev->data;
 
-    data->activity_state = zmk_activity_get_state();
-    data->indicators = zmk_hid_indicators_get_current_profile();
-    data->usb_powered = zmk_usb_is_powered();
-
     for (int i = 0; i < config->num_indicators; i++) {
-        const int err = update_indicator(&config->indicators[i], data);
+        const int err = update_indicator(&config->indicators[i], data, i);
         if (err) {
             return err;
         }
@@ -109,6 +147,29 @@ static int update_device(const struct device *dev) {
     return 0;
 }
 
+static int update_device(const struct device *dev) {
+    struct indicator_led_data *data = dev->data;
+
+    data->activity_state = zmk_activity_get_state();
+    data->indicators = zmk_hid_indicators_get_current_profile();
+    data->usb_powered = zmk_usb_is_powered();
+
+    // LEDs can't be lit while the keyboard is asleep, so let runtime PM suspend
+    // the device then. Suspending it turns off all LEDs. If runtime PM isn't
+    // enabled, these do nothing and update_leds() turns off the LEDs instead.
+    const bool awake = data->usb_powered || data->activity_state != ZMK_ACTIVITY_SLEEP;
+    if (awake != data->runtime_held) {
+        const int err = awake ? pm_device_runtime_get(dev) : pm_device_runtime_put(dev);
+        if (err < 0) {
+            LOG_ERR("Failed to %s %s: %d", awake ? "resume" : "suspend", dev->name, err);
+        } else {
+            data->runtime_held = awake;
+        }
+    }
+
+    return update_leds(dev);
+}
+
 #define INST_DEV(n) DEVICE_DT_GET(DT_DRV_INST(n)),
 static const struct device *all_instances[] = {DT_INST_FOREACH_STATUS_OKAY(INST_DEV)};
 
@@ -130,7 +191,17 @@ static int indicator_led_event_listener(const zmk_event_t *eh) {
     return ZMK_EV_EVENT_BUBBLE;
 }
 
-static int indicator_led_init(const struct device *dev) { return update_device(dev); }
+static int indicator_led_init(const struct device *dev) {
+#if IS_ENABLED(CONFIG_PM_DEVICE_RUNTIME)
+    const int err = pm_device_runtime_enable(dev);
+    if (err) {
+        LOG_ERR("Failed to enable runtime PM: %d", err);
+        return err;
+    }
+#endif
+
+    return update_device(dev);
+}
 
 ZMK_LISTENER(indicator_led, indicator_led_event_listener);
 ZMK_SUBSCRIPTION(indicator_led, zmk_activity_state_changed);
@@ -139,17 +210,25 @@ ZMK_SUBSCRIPTION(indicator_led, zmk_usb_conn_state_changed);
 
 #if IS_ENABLED(CONFIG_PM_DEVICE)
 
+// With runtime PM, this runs when the keyboard goes to sleep or wakes up.
+// Without it, this handles system-managed suspend, e.g. when ZMK suspends all
+// devices before turning off.
 static int indicator_led_init_pm_action(const struct device *dev, enum pm_device_action action) {
     struct indicator_led_data *data = dev->data;
 
     switch (action) {
     case PM_DEVICE_ACTION_SUSPEND:
         data->pm_suspended = true;
-        return update_device(dev);
+        return update_leds(dev);
 
     case PM_DEVICE_ACTION_RESUME:
         data->pm_suspended = false;
-        return update_device(dev);
+        return update_leds(dev);
+
+    case PM_DEVICE_ACTION_TURN_OFF:
+    case PM_DEVICE_ACTION_TURN_ON:
+        // The device is already suspended and all LEDs are off.
+        return 0;
 
     default:
         return -ENOTSUP;
@@ -161,17 +240,30 @@ static int indicator_led_init_pm_action(const struct device *dev, enum pm_device
 #define LED_DT_SPEC_GET_BY_IDX(node_id, prop, idx)                                                 \
     LED_DT_SPEC_GET(DT_PHANDLE_BY_IDX(node_id, prop, idx))
 
+// PWM LEDs need their PWM controller to be active. Other LEDs need the LED
+// controller itself.
+#define LED_PM_DEV(led_node)                                                                       \
+    COND_CODE_1(DT_NODE_HAS_PROP(led_node, pwms), (DEVICE_DT_GET(DT_PWMS_CTLR(led_node))),         \
+                (DEVICE_DT_GET(DT_PARENT(led_node))))
+
+#define LED_PM_DEV_BY_IDX(node_id, prop, idx) LED_PM_DEV(DT_PHANDLE_BY_IDX(node_id, prop, idx))
+
 #define CHILD_LEDS_ARRAY(inst) DT_CAT(indicator_led_dt_spec_, inst)
+#define CHILD_PM_DEVS_ARRAY(inst) DT_CAT(indicator_led_pm_devs_, inst)
 
 #define DEFINE_CHILD_LEDS(inst)                                                                    \
     static const struct led_dt_spec CHILD_LEDS_ARRAY(inst)[] = {                                   \
         DT_FOREACH_PROP_ELEM_SEP(inst, leds, LED_DT_SPEC_GET_BY_IDX, (, )),                        \
+    };                                                                                             \
+    static const struct device *const CHILD_PM_DEVS_ARRAY(inst)[] = {                              \
+        DT_FOREACH_PROP_ELEM_SEP(inst, leds, LED_PM_DEV_BY_IDX, (, )),                             \
     };
 
 #define CHILD_CONFIG(inst)                                                                         \
     {                                                                                              \
         .num_leds = ARRAY_SIZE(CHILD_LEDS_ARRAY(inst)),                                            \
         .leds = CHILD_LEDS_ARRAY(inst),                                                            \
+        .pm_devs = CHILD_PM_DEVS_ARRAY(inst),                                                      \
         .indicator = DT_PROP(inst, indicator),                                                     \
         .active_brightness = DT_PROP_OR(inst, active_brightness, 100),                             \
         .inactive_brightness = DT_PROP_OR(inst, inactive_brightness, 0),                           \
@@ -179,6 +271,8 @@ static int indicator_led_init_pm_action(const struct device *dev, enum pm_device
     },
 
 #define INDICATOR_LED_DEVICE(n)                                                                    \
+    BUILD_ASSERT(DT_INST_CHILD_NUM(n) <= 32, "Too many indicators in one zmk,indicator-leds");     \
+                                                                                                   \
     DT_INST_FOREACH_CHILD(n, DEFINE_CHILD_LEDS)                                                    \
                                                                                                    \
     static const struct indicator_led_child_config indicator_led_children_##n[] = {                \
@@ -194,6 +288,8 @@ static int indicator_led_init_pm_action(const struct device *dev, enum pm_device
         .indicators = 0,                                                                           \
         .usb_powered = true,                                                                       \
         .pm_suspended = false,                                                                     \
+        .runtime_held = false,                                                                     \
+        .held_mask = 0,                                                                            \
     };                                                                                             \
                                                                                                    \
     PM_DEVICE_DT_INST_DEFINE(n, indicator_led_init_pm_action);                                     \
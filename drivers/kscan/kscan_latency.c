@@ -0,0 +1,293 @@
+#define DT_DRV_COMPAT zmk_kscan_latency
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/kscan.h>
+#include <zephyr/kernel.h>
+#include <zephyr/shell/shell.h>
+#include <zephyr/timing/timing.h>
+#include <string.h>
+
+#include <zmk/event_manager.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(zmk, CONFIG_ZMK_LOG_LEVEL);
+
+// Passes through another kscan device and records how long each key event
+// spends in each stage of processing:
+//
+// - Edge: the first GPIO edge after the matrix was idle, seen in the GPIO ISR.
+// - Debounce: the wrapped kscan reports the key event.
+// - Keymap: ZMK raises the position event.
+// - Behavior: a behavior raises a keycode event, which the HID listener turns
+//   into a report.
+//
+// Only one event is tracked at a time, and the kscan matrix only uses
+// interrupts while no keys are held, so the edge stage is only measured for
+// the first press after the matrix was idle.
+//
+// Only keycode events raised for the same position event as the tracked key
+// are counted, so keycodes from encoders or other sources aren't attributed to
+// it.
+//
+// Stages are timed with the timing API, which uses the CPU cycle counter, since
+// the kernel cycle counter only runs at 32768 Hz on nRF52. Recording an event
+// only reads the counter and increments a histogram bucket. All conversion to
+// time units happens when the stats are printed.
+
+BUILD_ASSERT(DT_NUM_INST_STATUS_OKAY(DT_DRV_COMPAT) <= 1,
+             "Only one zmk,kscan-latency instance is supported");
+
+enum latency_stage {
+    STAGE_EDGE_TO_DEBOUNCE,
+    STAGE_DEBOUNCE_TO_KEYMAP,
+    STAGE_KEYMAP_TO_BEHAVIOR,
+    STAGE_EDGE_TO_BEHAVIOR,
+    STAGE_COUNT,
+};
+
+static const char *const stage_names[STAGE_COUNT] = {
+    [STAGE_EDGE_TO_DEBOUNCE] = "edge -> debounce",
+    [STAGE_DEBOUNCE_TO_KEYMAP] = "debounce -> keymap",
+    [STAGE_KEYMAP_TO_BEHAVIOR] = "keymap -> behavior",
+    [STAGE_EDGE_TO_BEHAVIOR] = "edge -> behavior",
+};
+
+// Bucket N holds durations with bit (N - 1) as the highest set bit.
+#define HISTOGRAM_BUCKETS 33
+
+struct latency_stats {
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint32_t buckets[HISTOGRAM_BUCKETS];
+};
+
+static struct latency_stats stats[STAGE_COUNT];
+
+static timing_t edge_time;
+static timing_t event_start_time;
+static timing_t debounce_time;
+static timing_t keymap_time;
+static int64_t keymap_event_timestamp;
+static bool edge_pending;
+static bool event_start_pending;
+static bool debounce_pending;
+static bool keymap_pending;
+
+static void record(enum latency_stage stage, timing_t start, timing_t end) {
+    struct latency_stats *s = &stats[stage];
+    const uint32_t delta = (uint32_t)timing_cycles_get(&start, &end);
+    const int bucket = delta ? 32 - __builtin_clz(delta) : 0;
+
+    s->count++;
+    s->total += delta;
+    s->max = MAX(s->max, delta);
+    s->buckets[bucket]++;
+}
+
+struct kscan_latency_config {
+    const struct device *kscan;
+    size_t num_edge_gpios;
+    const struct gpio_dt_spec *edge_gpios;
+};
+
+struct kscan_latency_data {
+    const struct device *dev;
+    kscan_callback_t callback;
+    struct gpio_callback *edge_callbacks;
+};
+
+static void kscan_latency_edge_handler(const struct device *port, struct gpio_callback *cb,
+                                       gpio_port_pins_t pins) {
+    if (!edge_pending) {
+        edge_time = timing_counter_get();
+        edge_pending = true;
+    }
+}
+
+static void kscan_latency_callback(const struct device *kscan, uint32_t row, uint32_t column,
+                                   bool pressed) {
+    const struct device *dev = DEVICE_DT_INST_GET(0);
+    struct kscan_latency_data *data = dev->data;
+
+    debounce_time = timing_counter_get();
+    debounce_pending = true;
+    keymap_pending = false;
+    event_start_pending = edge_pending;
+
+    if (edge_pending) {
+        record(STAGE_EDGE_TO_DEBOUNCE, edge_time, debounce_time);
+        event_start_time = edge_time;
+        edge_pending = false;
+    }
+
+    if (data->callback) {
+        data->callback(dev, row, column, pressed);
+    }
+}
+
+static int kscan_latency_configure(const struct device *dev, kscan_callback_t callback) {
+    const struct kscan_latency_config *config = dev->config;
+    struct kscan_latency_data *data = dev->data;
+
+    data->callback = callback;
+    return kscan_config(config->kscan, kscan_latency_callback);
+}
+
+static int kscan_latency_enable(const struct device *dev) {
+    const struct kscan_latency_config *config = dev->config;
+
+    return kscan_enable_callback(config->kscan);
+}
+
+static int kscan_latency_disable(const struct device *dev) {
+    const struct kscan_latency_config *config = dev->config;
+
+    return kscan_disable_callback(config->kscan);
+}
+
+static int kscan_latency_init(const struct device *dev) {
+    const struct kscan_latency_config *config = dev->config;
+    struct kscan_latency_data *data = dev->data;
+
+    if (!device_is_ready(config->kscan)) {
+        LOG_ERR("kscan device is not ready");
+        return -ENODEV;
+    }
+
+    data->dev = dev;
+
+    timing_init();
+    timing_start();
+
+    // The wrapped kscan driver owns the pin configuration and interrupts. This
+    // only adds a second callback to see when they fire.
+    for (int i = 0; i < config->num_edge_gpios; i++) {
+        const struct gpio_dt_spec *spec = &config->edge_gpios[i];
+
+        gpio_init_callback(&data->edge_callbacks[i], kscan_latency_edge_handler, BIT(spec->pin));
+        const int err = gpio_add_callback_dt(spec, &data->edge_callbacks[i]);
+        if (err) {
+            LOG_ERR("Failed to add callback for %s pin %u: %d", spec->port->name, spec->pin, err);
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+static int kscan_latency_event_listener(const zmk_event_t *eh) {
+    const timing_t now = timing_counter_get();
+
+    const struct zmk_position_state_changed *position_ev = as_zmk_position_state_changed(eh);
+    if (position_ev) {
+        // Only local position events come from this kscan device.
+        if (debounce_pending && position_ev->source == ZMK_POSITION_STATE_CHANGE_SOURCE_LOCAL) {
+            record(STAGE_DEBOUNCE_TO_KEYMAP, debounce_time, now);
+            debounce_pending = false;
+            keymap_time = now;
+            keymap_event_timestamp = position_ev->timestamp;
+            keymap_pending = true;
+        }
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_keycode_state_changed *keycode_ev = as_zmk_keycode_state_changed(eh);
+    if (keycode_ev) {
+        // Behaviors pass on the timestamp of the position event that triggered
+        // them, which separates this key's keycodes from those of encoders.
+        if (keymap_pending && keycode_ev->timestamp == keymap_event_timestamp) {
+            record(STAGE_KEYMAP_TO_BEHAVIOR, keymap_time, now);
+            keymap_pending = false;
+
+            if (event_start_pending) {
+                record(STAGE_EDGE_TO_BEHAVIOR, event_start_time, now);
+                event_start_pending = false;
+            }
+        }
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(kscan_latency, kscan_latency_event_listener);
+ZMK_SUBSCRIPTION(kscan_latency, zmk_position_state_changed);
+ZMK_SUBSCRIPTION(kscan_latency, zmk_keycode_state_changed);
+
+static DEVICE_API(kscan, kscan_latency_api) = {
+    .config = kscan_latency_configure,
+    .enable_callback = kscan_latency_enable,
+    .disable_callback = kscan_latency_disable,
+};
+
+#define KSCAN_LATENCY_DEFINE(n)                                                                    \
+    static const struct gpio_dt_spec kscan_latency_edge_gpios_##n[] = {                            \
+        DT_INST_FOREACH_PROP_ELEM_SEP(n, edge_gpios, GPIO_DT_SPEC_GET_BY_IDX, (, ))};              \
+    static struct gpio_callback                                                                    \
+        kscan_latency_edge_callbacks_##n[ARRAY_SIZE(kscan_latency_edge_gpios_##n)];                \
+                                                                                                   \
+    static struct kscan_latency_data kscan_latency_data_##n = {                                    \
+        .edge_callbacks = kscan_latency_edge_callbacks_##n,                                        \
+    };                                                                                             \
+    static const struct kscan_latency_config kscan_latency_config_##n = {                          \
+        .kscan = DEVICE_DT_GET(DT_INST_PHANDLE(n, kscan)),                                         \
+        .num_edge_gpios = ARRAY_SIZE(kscan_latency_edge_gpios_##n),                                \
+        .edge_gpios = kscan_latency_edge_gpios_##n,                                                \
+    };                                                                                             \
+                                                                                                   \
+    DEVICE_DT_INST_DEFINE(n, kscan_latency_init, NULL, &kscan_latency_data_##n,                    \
+                          &kscan_latency_config_##n, POST_KERNEL, CONFIG_KSCAN_INIT_PRIORITY,      \
+                          &kscan_latency_api);
+
+DT_INST_FOREACH_STATUS_OKAY(KSCAN_LATENCY_DEFINE)
+
+#if IS_ENABLED(CONFIG_SHELL)
+
+static uint32_t cycles_to_us(uint64_t cycles) {
+    return (uint32_t)(timing_cycles_to_ns(cycles) / NSEC_PER_USEC);
+}
+
+static int cmd_key_latency_show(const struct shell *sh, size_t argc, char **argv) {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const struct latency_stats *s = &stats[i];
+
+        shell_print(sh, "%s: %u events", stage_names[i], s->count);
+        if (s->count == 0) {
+            continue;
+        }
+
+        shell_print(sh, "  avg %u us, max %u us", cycles_to_us(s->total / s->count),
+                    cycles_to_us(s->max));
+
+        for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+            if (s->buckets[b] == 0) {
+                continue;
+            }
+
+            const uint64_t upper = BIT64(b);
+            shell_print(sh, "  < %u us: %u", cycles_to_us(upper), s->buckets[b]);
+        }
+    }
+
+    return 0;
+}
+
+static int cmd_key_latency_reset(const struct shell *sh, size_t argc, char **argv) {
+    memset(stats, 0, sizeof(stats));
+    shell_print(sh, "Latency stats cleared");
+    return 0;
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_key_latency,
+                               SHELL_CMD(show, NULL, "Print latency histograms",
+                                         cmd_key_latency_show),
+                               SHELL_CMD(reset, NULL, "Clear latency histograms",
+                                         cmd_key_latency_reset),
+                               SHELL_SUBCMD_SET_END);
+
+SHELL_CMD_REGISTER(key_latency, &sub_key_latency, "Key event latency measurements", NULL);
+
+#endif // IS_ENABLED(CONFIG_SHELL)
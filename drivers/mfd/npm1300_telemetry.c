@@ -0,0 +1,56 @@
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+
+#include <drivers/npm1300_telemetry.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(npm1300_telemetry, CONFIG_MFD_LOG_LEVEL);
+
+// The nPM1300 only has one charger, so a single cache entry is enough.
+static K_MUTEX_DEFINE(cache_lock);
+static const struct device *cached_dev = NULL;
+static int64_t fetch_time;
+
+static int fetch_if_stale(const struct device *charger) {
+    const int64_t now = k_uptime_get();
+
+    if (cached_dev == charger && now - fetch_time < CONFIG_NPM1300_TELEMETRY_MAX_AGE_MS) {
+        return 0;
+    }
+
+    const int ret = sensor_sample_fetch(charger);
+    if (ret) {
+        cached_dev = NULL;
+        return ret;
+    }
+
+    LOG_DBG("Fetched new samples");
+
+    cached_dev = charger;
+    fetch_time = now;
+    return 0;
+}
+
+int npm1300_telemetry_get(const struct device *charger, enum sensor_channel chan,
+                          struct sensor_value *val) {
+    k_mutex_lock(&cache_lock, K_FOREVER);
+
+    int ret = fetch_if_stale(charger);
+    if (ret == 0) {
+        ret = sensor_channel_get(charger, chan, val);
+    }
+
+    k_mutex_unlock(&cache_lock);
+    return ret;
+}
+
+void npm1300_telemetry_invalidate(const struct device *charger) {
+    k_mutex_lock(&cache_lock, K_FOREVER);
+
+    if (cached_dev == charger) {
+        cached_dev = NULL;
+    }
+
+    k_mutex_unlock(&cache_lock);
+}
@@ -0,0 +1,85 @@
+#define DT_DRV_COMPAT zmk_power_domain_regulator
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/regulator.h>
+#include <zephyr/kernel.h>
+#include <zephyr/pm/device.h>
+#include <zephyr/pm/device_runtime.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(power_domain_regulator, CONFIG_PM_DEVICE_LOG_LEVEL);
+
+// A power domain which is powered by a regulator, e.g. a PMIC load switch.
+//
+// Devices in the domain are notified with TURN_ON after the regulator is
+// enabled and TURN_OFF before it is disabled, so they can reinitialize or stop
+// driving pins that would otherwise back-power the unpowered devices.
+
+struct power_domain_regulator_config {
+    const struct device *regulator;
+    uint32_t startup_delay_us;
+};
+
+static int power_domain_regulator_pm_action(const struct device *dev,
+                                            enum pm_device_action action) {
+    const struct power_domain_regulator_config *config = dev->config;
+    int ret;
+
+    switch (action) {
+    case PM_DEVICE_ACTION_RESUME:
+        ret = regulator_enable(config->regulator);
+        if (ret) {
+            LOG_ERR("Failed to enable regulator: %d", ret);
+            return ret;
+        }
+
+        if (config->startup_delay_us > 0) {
+            k_sleep(K_USEC(config->startup_delay_us));
+        }
+
+        pm_device_children_action_run(dev, PM_DEVICE_ACTION_TURN_ON, NULL);
+        return 0;
+
+    case PM_DEVICE_ACTION_SUSPEND:
+        pm_device_children_action_run(dev, PM_DEVICE_ACTION_TURN_OFF, NULL);
+
+        ret = regulator_disable(config->regulator);
+        if (ret) {
+            LOG_ERR("Failed to disable regulator: %d", ret);
+            return ret;
+        }
+        return 0;
+
+    case PM_DEVICE_ACTION_TURN_ON:
+    case PM_DEVICE_ACTION_TURN_OFF:
+        return 0;
+
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int power_domain_regulator_init(const struct device *dev) {
+    const struct power_domain_regulator_config *config = dev->config;
+
+    if (!device_is_ready(config->regulator)) {
+        LOG_ERR("Regulator %s is not ready", config->regulator->name);
+        return -ENODEV;
+    }
+
+    return pm_device_driver_init(dev, power_domain_regulator_pm_action);
+}
+
+#define POWER_DOMAIN_REGULATOR_DEFINE(n)                                                           \
+    static const struct power_domain_regulator_config power_domain_regulator_config_##n = {        \
+        .regulator = DEVICE_DT_GET(DT_INST_PHANDLE(n, regulator)),                                 \
+        .startup_delay_us = DT_INST_PROP(n, startup_delay_us),                                     \
+    };                                                                                             \
+                                                                                                   \
+    PM_DEVICE_DT_INST_DEFINE(n, power_domain_regulator_pm_action);                                 \
+                                                                                                   \
+    DEVICE_DT_INST_DEFINE(n, power_domain_regulator_init, PM_DEVICE_DT_INST_GET(n), NULL,          \
+                          &power_domain_regulator_config_##n, POST_KERNEL,                         \
+                          CONFIG_ZMK_POWER_DOMAIN_REGULATOR_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(POWER_DOMAIN_REGULATOR_DEFINE)
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <zephyr/drivers/emul.h>
+
+/**
+ * Backend API for the nPM1300 I2C emulator.
+ *
+ * The emulator is a plain register file with the MAIN event/interrupt
+ * registers implemented, so tests can set whatever state the drivers should
+ * read and then raise the matching PMIC events.
+ */
+
+struct emul_npm1300_stats {
+    // Number of I2C transfers addressed to the PMIC.
+    uint32_t transactions;
+    // Number of register bytes read and written, not counting the address.
+    uint32_t bytes_read;
+    uint32_t bytes_written;
+    // Number of times the MFD's interrupt work ran, counted by its read of the
+    // MAIN registers.
+    uint32_t interrupt_work_runs;
+};
+
+/** Set a register without raising any events. */
+void emul_npm1300_set_reg(const struct emul *target, uint8_t base, uint8_t offset, uint8_t value);
+
+/** Get the current value of a register. */
+uint8_t emul_npm1300_get_reg(const struct emul *target, uint8_t base, uint8_t offset);
+
+/**
+ * Set event bits in a MAIN event group and update the interrupt line.
+ *
+ * @p group is the offset of the group's SET register, e.g. 0x16 for VBUS.
+ */
+void emul_npm1300_raise_event(const struct emul *target, uint8_t group, uint8_t mask);
+
+/** Connect or disconnect VBUS and raise the VBUS detected/removed event. */
+void emul_npm1300_set_vbus(const struct emul *target, bool present);
+
+/**
+ * Set BCHGCHARGESTATUS and raise the charge completed event if the completed
+ * bit was newly set.
+ */
+void emul_npm1300_set_charge_status(const struct emul *target, uint8_t status);
+
+/** Set the battery voltage ADC result. */
+void emul_npm1300_set_vbat_mv(const struct emul *target, int mv);
+
+/** Get the transfer counters. */
+void emul_npm1300_get_stats(const struct emul *target, struct emul_npm1300_stats *stats);
+
+/** Reset the transfer counters to zero. */
+void emul_npm1300_reset_stats(const struct emul *target);
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/sensor.h>
+
+/**
+ * Read a channel from an nPM1300 charger sensor device.
+ *
+ * sensor_sample_fetch() reads every channel at once, but that takes several I2C
+ * transactions: six with Zephyr 4.1's driver (charger status, error reason, an
+ * ADC result burst, two writes to start the next measurements, and VBUS
+ * status). This only fetches new samples if the cached ones are older than
+ * CONFIG_NPM1300_TELEMETRY_MAX_AGE_MS, so drivers that read several channels in
+ * a row share one fetch instead of each doing their own.
+ *
+ * @param charger The "nordic,npm1300-charger" device.
+ * @param chan The channel to read.
+ * @param val Receives the channel value.
+ * @return 0 on success or a negative error code.
+ */
+int npm1300_telemetry_get(const struct device *charger, enum sensor_channel chan,
+                          struct sensor_value *val);
+
+/**
+ * Discard the cached samples, so the next read fetches new ones.
+ *
+ * Call this when the PMIC reports an event that changes the values.
+ */
+void npm1300_telemetry_invalidate(const struct device *charger);
@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""
+Decodes logs captured from a build using the zmk-rtt-logging-dict or
+zmk-ble-logging-dict snippets.
+
+This is a wrapper around Zephyr's dictionary log parser which finds the log
+database for a build directory. The database must come from the same build as
+the firmware that produced the log, or the output will be garbage.
+
+Examples:
+
+    # Binary RTT capture, e.g. from JLinkRTTLogger
+    decode_dict_log.py -d build/marten_numpad rtt.bin
+
+    # Hex text, e.g. copied from a BLE notification log
+    decode_dict_log.py -d build/marten_numpad --hex ble.txt
+"""
+
+import argparse
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+DATABASE_PATH = Path("zephyr/log_dictionary.json")
+PARSER_PATH = Path("scripts/logging/dictionary/log_parser.py")
+
+
+def find_zephyr_base(build_dir: Path) -> Path:
+    if base := os.environ.get("ZEPHYR_BASE"):
+        return Path(base)
+
+    # Fall back to the ZEPHYR_BASE the build was configured with.
+    cache = build_dir / "CMakeCache.txt"
+    if cache.exists():
+        for line in cache.read_text(encoding="utf-8").splitlines():
+            if line.startswith("ZEPHYR_BASE:"):
+                return Path(line.partition("=")[2])
+
+    sys.exit("Could not find Zephyr. Set the ZEPHYR_BASE environment variable.")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument(
+        "-d",
+        "--build-dir",
+        type=Path,
+        default=Path("build"),
+        help="Build directory of the firmware that produced the log (default: build)",
+    )
+    parser.add_argument(
+        "--hex", action="store_true", help="Log file contains hex text instead of binary"
+    )
+    parser.add_argument("logfile", type=Path, help="Captured log output")
+    args = parser.parse_args()
+
+    database = args.build_dir / DATABASE_PATH
+    if not database.exists():
+        sys.exit(
+            f"{database} does not exist. Was this built with a dictionary logging snippet?"
+        )
+
+    log_parser = find_zephyr_base(args.build_dir) / PARSER_PATH
+    if not log_parser.exists():
+        sys.exit(f"{log_parser} does not exist.")
+
+    command = [sys.executable, str(log_parser)]
+    if args.hex:
+        command.append("--hex")
+    command += [str(database), str(args.logfile)]
+
+    sys.exit(subprocess.run(command, check=False).returncode)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""
+Converts the output of the Marten Numpad's "pmic stream" shell command to CSV.
+
+Either read a raw capture of the shell's serial port from a file, or give
+--port to start the stream, capture it, and stop it when interrupted with
+Ctrl+C (requires pyserial).
+
+Examples:
+
+    pmic_stream_to_csv.py capture.bin > capture.csv
+    pmic_stream_to_csv.py --port COM5 --interval 1000 -o capture.csv
+"""
+
+import argparse
+import csv
+import struct
+import sys
+from typing import BinaryIO, Iterator, NamedTuple
+
+SYNC = b"\xa5\x5a"
+RECORD = struct.Struct("<2sIHiBBBB")
+
+FLAG_VBUS_PRESENT = 0x01
+FLAG_DIE_TEMP_HIGH = 0x02
+
+STATUS_COMPLETED = 0x02
+STATUS_CHARGING_MASK = 0x04 | 0x08 | 0x10
+
+
+class Record(NamedTuple):
+    uptime_ms: int
+    voltage_mv: int
+    current_ua: int
+    soc: int
+    status: int
+    flags: int
+
+
+def crc8_ccitt(data: bytes) -> int:
+    crc = 0
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x07 if crc & 0x80 else crc << 1) & 0xFF
+    return crc
+
+
+def read_records(stream: BinaryIO, stats: dict) -> Iterator[Record]:
+    buffer = b""
+
+    while chunk := stream.read(RECORD.size * 16):
+        buffer += chunk
+
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                # Keep a trailing byte in case it is the start of a sync word.
+                stats["skipped"] += max(len(buffer) - 1, 0)
+                buffer = buffer[-1:]
+                break
+
+            stats["skipped"] += start
+            buffer = buffer[start:]
+            if len(buffer) < RECORD.size:
+                break
+
+            data = buffer[: RECORD.size]
+            if crc8_ccitt(data[:-1]) != data[-1]:
+                # Not a real record (or a corrupted one). Resync after this sync word.
+                stats["bad_crc"] += 1
+                stats["skipped"] += 1
+                buffer = buffer[1:]
+                continue
+
+            buffer = buffer[RECORD.size :]
+            _, *fields, _ = RECORD.unpack(data)
+            yield Record(*fields)
+
+
+def status_name(status: int) -> str:
+    if status & STATUS_COMPLETED:
+        return "full"
+    if status & STATUS_CHARGING_MASK:
+        return "charging"
+    return "not charging"
+
+
+def write_csv(records: Iterator[Record], output) -> None:
+    writer = csv.writer(output, lineterminator="\n")
+    writer.writerow(
+        [
+            "uptime_ms",
+            "voltage_mv",
+            "current_ua",
+            "soc_percent",
+            "status",
+            "status_reg",
+            "vbus",
+            "die_temp_high",
+        ]
+    )
+
+    for record in records:
+        writer.writerow(
+            [
+                record.uptime_ms,
+                record.voltage_mv,
+                record.current_ua,
+                record.soc,
+                status_name(record.status),
+                f"0x{record.status:02x}",
+                int(bool(record.flags & FLAG_VBUS_PRESENT)),
+                int(bool(record.flags & FLAG_DIE_TEMP_HIGH)),
+            ]
+        )
+        output.flush()
+
+
+class SerialStream:
+    """Starts the stream on a serial port and stops it when closed."""
+
+    def __init__(self, port: str, interval: int):
+        import serial  # pylint: disable=import-outside-toplevel
+
+        self.serial = serial.Serial(port, timeout=1)
+        self.serial.reset_input_buffer()
+        self.serial.write(f"pmic stream {interval}\r\n".encode())
+        # Skip the command echo and the message printed before the stream starts.
+        self.serial.read_until(b"stop.")
+
+    def read(self, size: int) -> bytes:
+        data = b""
+        # Return an empty result only when the port is closed, not on timeout.
+        while not data:
+            data = self.serial.read(size)
+        return data
+
+    def close(self):
+        self.serial.write(b"\x03")
+        self.serial.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter
+    )
+    parser.add_argument("input", nargs="?", help="Captured stream. Reads stdin if omitted.")
+    parser.add_argument("--port", help="Serial port of the keyboard's shell")
+    parser.add_argument(
+        "--interval", type=int, default=1000, help="Stream interval in ms for --port"
+    )
+    parser.add_argument("-o", "--output", help="Output file. Writes stdout if omitted.")
+    args = parser.parse_args()
+
+    if args.port:
+        stream = SerialStream(args.port, args.interval)
+    elif args.input:
+        stream = open(args.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    output = open(args.output, "w", encoding="utf-8", newline="") if args.output else sys.stdout
+    stats = {"skipped": 0, "bad_crc": 0}
+
+    try:
+        write_csv(read_records(stream, stats), output)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        stream.close()
+        if output is not sys.stdout:
+            output.close()
+
+    if stats["skipped"] or stats["bad_crc"]:
+        print(
+            f"Skipped {stats['skipped']} bytes outside records, {stats['bad_crc']} bad CRCs",
+            file=sys.stderr,
+        )
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,161 @@
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/charger.h>
+#include <zephyr/drivers/emul.h>
+#include <zephyr/drivers/fuel_gauge.h>
+#include <zephyr/drivers/mfd/npm1300.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include <drivers/emul_npm1300.h>
+#include <drivers/npm1300_telemetry.h>
+
+// Counts the I2C transactions the nPM1300 drivers use for each API call, so
+// changes that add bus traffic show up as test failures.
+
+#define VBUS_BASE 0x02U
+#define VBUS_OFFSET_STATUS 0x07U
+
+#define ERRLOG_BASE 0x0EU
+#define ERRLOG_OFFSET_TASKCLRERRLOG 0x00U
+#define ERRLOG_OFFSET_RSTCAUSE 0x03U
+
+// Transactions used by one sensor_sample_fetch() of the charger with Zephyr
+// 4.1: read charger status, read error reason, burst read the ADC results,
+// write the temperature tasks, write the VBAT task, and read VBUS status.
+#define FETCH_TRANSACTIONS 6
+
+// Time for work items triggered by an event to finish.
+#define WORK_SETTLE_TIME K_MSEC(10)
+
+static const struct emul *pmic_emul = EMUL_DT_GET(DT_NODELABEL(npm1300_pmic));
+static const struct device *pmic = DEVICE_DT_GET(DT_NODELABEL(npm1300_pmic));
+static const struct device *charger_sensor = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger));
+static const struct device *charger = DEVICE_DT_GET(DT_NODELABEL(npm1300_charger_wrapper));
+static const struct device *fuel_gauge = DEVICE_DT_GET(DT_NODELABEL(npm1300_fuel_gauge));
+
+static struct emul_npm1300_stats get_stats(void) {
+    struct emul_npm1300_stats stats;
+    emul_npm1300_get_stats(pmic_emul, &stats);
+    return stats;
+}
+
+static void *npm1300_setup(void) {
+    zassert_true(device_is_ready(pmic));
+    zassert_true(device_is_ready(charger_sensor));
+    zassert_true(device_is_ready(charger));
+    zassert_true(device_is_ready(fuel_gauge));
+
+    // Let the charger read its initial state after boot.
+    k_sleep(WORK_SETTLE_TIME);
+
+    npm1300_telemetry_invalidate(charger_sensor);
+    emul_npm1300_reset_stats(pmic_emul);
+
+    struct sensor_value val;
+    zassert_ok(npm1300_telemetry_get(charger_sensor, SENSOR_CHAN_GAUGE_VOLTAGE, &val));
+
+    zassert_equal(get_stats().transactions, FETCH_TRANSACTIONS);
+
+    return NULL;
+}
+
+static void npm1300_before(void *fixture) {
+    npm1300_telemetry_invalidate(charger_sensor);
+    emul_npm1300_reset_stats(pmic_emul);
+}
+
+ZTEST_SUITE(npm1300, NULL, npm1300_setup, npm1300_before, NULL, NULL);
+
+ZTEST(npm1300, test_mfd_reg_read) {
+    uint8_t value;
+    zassert_ok(mfd_npm1300_reg_read(pmic, VBUS_BASE, VBUS_OFFSET_STATUS, &value));
+
+    const struct emul_npm1300_stats stats = get_stats();
+    zassert_equal(stats.transactions, 1);
+    zassert_equal(stats.bytes_read, 1);
+    zassert_equal(stats.bytes_written, 0);
+}
+
+ZTEST(npm1300, test_mfd_reg_read_burst) {
+    uint8_t values[3];
+    zassert_ok(mfd_npm1300_reg_read_burst(pmic, ERRLOG_BASE, ERRLOG_OFFSET_RSTCAUSE, values,
+                                          sizeof(values)));
+
+    const struct emul_npm1300_stats stats = get_stats();
+    zassert_equal(stats.transactions, 1);
+    zassert_equal(stats.bytes_read, sizeof(values));
+    zassert_equal(stats.bytes_written, 0);
+}
+
+ZTEST(npm1300, test_mfd_reg_write) {
+    zassert_ok(mfd_npm1300_reg_write(pmic, ERRLOG_BASE, ERRLOG_OFFSET_TASKCLRERRLOG, 1U));
+
+    const struct emul_npm1300_stats stats = get_stats();
+    zassert_equal(stats.transactions, 1);
+    zassert_equal(stats.bytes_read, 0);
+    zassert_equal(stats.bytes_written, 1);
+}
+
+ZTEST(npm1300, test_fuel_gauge_props_share_one_fetch) {
+    union fuel_gauge_prop_val val;
+
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_VOLTAGE, &val));
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_AVG_CURRENT, &val));
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_ABSOLUTE_STATE_OF_CHARGE, &val));
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_RELATIVE_STATE_OF_CHARGE, &val));
+
+    zassert_equal(get_stats().transactions, FETCH_TRANSACTIONS);
+}
+
+ZTEST(npm1300, test_charger_shares_fuel_gauge_fetch) {
+    union fuel_gauge_prop_val fuel_gauge_val;
+    union charger_propval charger_val;
+
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_VOLTAGE, &fuel_gauge_val));
+    zassert_ok(charger_get_prop(charger, CHARGER_PROP_STATUS, &charger_val));
+    zassert_ok(charger_get_prop(charger, CHARGER_PROP_CHARGE_TYPE, &charger_val));
+
+    zassert_equal(get_stats().transactions, FETCH_TRANSACTIONS);
+}
+
+ZTEST(npm1300, test_charger_online_uses_no_bus) {
+    union charger_propval val;
+
+    zassert_ok(charger_get_prop(charger, CHARGER_PROP_ONLINE, &val));
+
+    zassert_equal(get_stats().transactions, 0);
+}
+
+ZTEST(npm1300, test_stale_samples_are_fetched_again) {
+    union fuel_gauge_prop_val val;
+
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_VOLTAGE, &val));
+    k_sleep(K_MSEC(CONFIG_NPM1300_TELEMETRY_MAX_AGE_MS));
+    zassert_ok(fuel_gauge_get_prop(fuel_gauge, FUEL_GAUGE_VOLTAGE, &val));
+
+    zassert_equal(get_stats().transactions, 2 * FETCH_TRANSACTIONS);
+}
+
+ZTEST(npm1300, test_vbus_event) {
+    union charger_propval val;
+
+    emul_npm1300_set_vbus(pmic_emul, true);
+    k_sleep(WORK_SETTLE_TIME);
+
+    // The MFD reads MAIN and clears the event, then the charger fetches its
+    // new state once.
+    const struct emul_npm1300_stats stats = get_stats();
+    zassert_equal(stats.interrupt_work_runs, 1);
+    zassert_equal(stats.transactions, 2 + FETCH_TRANSACTIONS);
+
+    zassert_ok(charger_get_prop(charger, CHARGER_PROP_ONLINE, &val));
+    zassert_equal(val.online, CHARGER_ONLINE_PROGRAMMABLE);
+
+    emul_npm1300_set_vbus(pmic_emul, false);
+    k_sleep(WORK_SETTLE_TIME);
+
+    zassert_ok(charger_get_prop(charger, CHARGER_PROP_ONLINE, &val));
+    zassert_equal(val.online, CHARGER_ONLINE_OFFLINE);
+}